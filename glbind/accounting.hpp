@@ -0,0 +1,296 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef GLAD_INSTRUMENT
+namespace graphics
+{
+    /**
+     * @brief what an OpenGL entry point does, queries stall until the driver answers
+     *
+     */
+    enum class CallKind
+    {
+        Query,
+        StateChange,
+        Draw
+    };
+
+    /**
+     * @brief sort an entry point by its name
+     *
+     * @param name
+     * @return CallKind
+     */
+    constexpr CallKind call_kind_of(std::string_view name) noexcept
+    {
+        if(name.starts_with("glGet") || name.starts_with("glIs") || name == "glCheckFramebufferStatus"
+            || name == "glReadPixels" || name == "glFinish" || name == "glClientWaitSync")
+            return CallKind::Query;
+        if(name.starts_with("glDraw") || name.starts_with("glMultiDraw") || name == "glClear" || name == "glBlitFramebuffer")
+            return CallKind::Draw;
+        return CallKind::StateChange;
+    }
+
+    /**
+     * @brief OpenGL calls counted by entry point and by kind
+     *
+     */
+    struct CallStats
+    {
+        std::vector<std::uint64_t> calls;
+        std::uint64_t query_count {0};
+        std::uint64_t state_change_count {0};
+        std::uint64_t draw_count {0};
+
+        std::uint64_t get_total() const noexcept
+        {
+            return query_count + state_change_count + draw_count;
+        }
+
+        /**
+         * @brief how many times an entry point was called
+         *
+         * @param name  such as "glDrawElements"
+         * @return std::uint64_t
+         */
+        std::uint64_t get_calls(std::string_view name) const noexcept;
+    };
+
+    /**
+     * @brief counts the OpenGL calls of a Context, each call is attributed to the innermost Scope or CallSection
+     * @note  only available when glad is built with GLAD_INSTRUMENT (the GLBIND_CALL_ACCOUNTING cmake option)
+     *
+     */
+    class CallAccounting
+    {
+    private:
+        struct ScopeSite
+        {
+            std::string_view file;
+            std::uint_least32_t line;
+
+            auto operator<=>(const ScopeSite&) const = default;
+        };
+
+        std::vector<CallKind> kinds;
+        CallStats total;
+        std::map<std::string,CallStats,std::less<>> named_sections;
+        std::map<ScopeSite,CallStats> scope_sections;
+        std::vector<CallStats*> section_stack;
+
+        /**
+         * @brief counters with a slot for every entry point, counting never has to allocate
+         *
+         * @return CallStats
+         */
+        CallStats make_stats() const noexcept(false)
+        {
+            CallStats stats;
+            stats.calls.resize(kinds.size());
+            return stats;
+        }
+
+        static void add_call(CallStats& stats,int index,CallKind kind) noexcept
+        {
+            ++stats.calls[index];
+            switch(kind)
+            {
+            case CallKind::Query:
+                ++stats.query_count;
+                break;
+            case CallKind::StateChange:
+                ++stats.state_change_count;
+                break;
+            case CallKind::Draw:
+                ++stats.draw_count;
+                break;
+            }
+        }
+
+        static void clear(CallStats& stats) noexcept
+        {
+            std::fill(stats.calls.begin(),stats.calls.end(),0);
+            stats.query_count = stats.state_change_count = stats.draw_count = 0;
+        }
+
+        static void append_json_string(std::string& out,std::string_view str) noexcept(false)
+        {
+            out += '"';
+            for(char c : str)
+            {
+                if(c == '"' || c == '\\')
+                    out += '\\';
+                out += c;
+            }
+            out += '"';
+        }
+
+        static void append_json(std::string& out,const CallStats& stats) noexcept(false)
+        {
+            out += "{\"total\":" + std::to_string(stats.get_total());
+            out += ",\"queries\":" + std::to_string(stats.query_count);
+            out += ",\"state_changes\":" + std::to_string(stats.state_change_count);
+            out += ",\"draws\":" + std::to_string(stats.draw_count);
+            out += ",\"calls\":{";
+            bool first {true};
+            for(std::size_t i = 0;i < stats.calls.size();i++)
+            {
+                if(stats.calls[i] == 0)
+                    continue;
+                if(!first)
+                    out += ',';
+                first = false;
+                append_json_string(out,gladGetCallName(static_cast<int>(i)));
+                out += ':' + std::to_string(stats.calls[i]);
+            }
+            out += "}}";
+        }
+
+    public:
+        /**
+         * @brief Construct a new Call Accounting object, every table the call hook needs is built here
+         *
+         */
+        CallAccounting() noexcept(false)
+            : kinds(gladGetCallCount())
+        {
+            for(std::size_t i = 0;i < kinds.size();i++)
+                kinds[i] = call_kind_of(gladGetCallName(static_cast<int>(i)));
+            total = make_stats();
+        }
+
+        CallAccounting(CallAccounting&) = delete;
+
+        /**
+         * @brief count one call of the entry point with the given glad index, it never allocates
+         *
+         * @param index
+         */
+        void count(int index) noexcept
+        {
+            const CallKind kind {kinds[index]};
+            add_call(total,index,kind);
+            if(!section_stack.empty())
+                add_call(*section_stack.back(),index,kind);
+        }
+
+        /**
+         * @brief attribute the following calls to a named section, such as a frame or a render pass
+         *
+         * @param name
+         */
+        void push_section(std::string_view name) noexcept(false)
+        {
+            auto it {named_sections.find(name)};
+            if(it == named_sections.end())
+                it = named_sections.emplace(std::string(name),make_stats()).first;
+            section_stack.push_back(&it->second);
+        }
+
+        /**
+         * @brief attribute the following calls to the Scope at location
+         *
+         * @param location
+         */
+        void push_scope(const std::source_location& location) noexcept(false)
+        {
+            const ScopeSite site {location.file_name(),location.line()};
+            auto it {scope_sections.find(site)};
+            if(it == scope_sections.end())
+                it = scope_sections.emplace(site,make_stats()).first;
+            section_stack.push_back(&it->second);
+        }
+
+        void pop_section() noexcept
+        {
+            if(!section_stack.empty())
+                section_stack.pop_back();
+        }
+
+        const CallStats& get_total() const noexcept
+        {
+            return total;
+        }
+
+        /**
+         * @brief get the calls attributed to a named section
+         *
+         * @param name
+         * @return const CallStats* nullptr if nothing was counted in it
+         */
+        const CallStats* get_section(std::string_view name) const noexcept
+        {
+            auto it {named_sections.find(name)};
+            return it == named_sections.end() ? nullptr : &it->second;
+        }
+
+        /**
+         * @brief drop every counter, sections that are still open keep counting
+         *
+         */
+        void reset() noexcept
+        {
+            clear(total);
+            for(auto& [name,stats] : named_sections)
+                clear(stats);
+            for(auto& [site,stats] : scope_sections)
+                clear(stats);
+        }
+
+        /**
+         * @brief dump the counters, Scopes are named by their call site as "file:line"
+         *
+         * @return std::string
+         */
+        std::string to_json() const noexcept(false)
+        {
+            std::string out {"{\"total\":"};
+            append_json(out,total);
+            out += ",\"sections\":{";
+            bool first {true};
+            for(const auto& [name,stats] : named_sections)
+            {
+                if(!first)
+                    out += ',';
+                first = false;
+                append_json_string(out,name);
+                out += ':';
+                append_json(out,stats);
+            }
+            out += "},\"scopes\":{";
+            first = true;
+            for(const auto& [site,stats] : scope_sections)
+            {
+                if(!first)
+                    out += ',';
+                first = false;
+                append_json_string(out,std::string(site.file) + ':' + std::to_string(site.line));
+                out += ':';
+                append_json(out,stats);
+            }
+            out += "}}";
+            return out;
+        }
+    };
+
+    inline std::uint64_t CallStats::get_calls(std::string_view name) const noexcept
+    {
+        for(std::size_t i = 0;i < calls.size();i++)
+        {
+            if(name == gladGetCallName(static_cast<int>(i)))
+                return calls[i];
+        }
+        return 0;
+    }
+}
+#endif
\ No newline at end of file
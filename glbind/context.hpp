@@ -0,0 +1,206 @@
+#pragma once
+
+#include "state.hpp"
+#include <atomic>
+
+#ifdef GLAD_INSTRUMENT
+#include "accounting.hpp"
+#endif
+
+namespace graphics
+{
+    /**
+     * @brief the glbind side of an OpenGL context, it owns the status cache and the Scope stack
+     * @note  a Context is current on one thread at a time, threads never share a status cache.
+     *        a thread that never made a Context current uses its own implicit one
+     * @warning make the OpenGL context current on the thread before making its Context current,
+     *          glbind can not see which OpenGL context is current by itself
+     */
+    class Context
+    {
+    private:
+        StatusCache status;
+        std::atomic<const char*> operation {nullptr};
+        std::atomic<unsigned int> operation_object {0};
+#ifdef GLAD_INSTRUMENT
+        CallAccounting accounting;
+#endif
+
+        static inline thread_local Context* current {nullptr};
+
+    public:
+        Context() noexcept = default;
+        Context(Context&) = delete;
+
+        ~Context() noexcept
+        {
+            if(current == this)
+                current = nullptr;
+        }
+
+        /**
+         * @brief make this Context the current one of the calling thread
+         * @note  the status cache moves with the Context, a Context can follow its OpenGL context to another thread
+         *
+         */
+        void make_current() noexcept
+        {
+            current = this;
+        }
+
+        /**
+         * @brief make the calling thread go back to its implicit Context
+         *
+         */
+        static void clear_current() noexcept
+        {
+            current = nullptr;
+        }
+
+        /**
+         * @brief get the Context current on the calling thread
+         *
+         * @return Context&
+         */
+        static Context& get_current() noexcept
+        {
+            if(current != nullptr)
+                return *current;
+
+            thread_local Context implicit_context;
+            return implicit_context;
+        }
+
+        StatusCache& get_status_cache() noexcept
+        {
+            return status;
+        }
+
+        /**
+         * @brief remember the glbind operation that is about to call OpenGL, errors are blamed on it
+         * @note  readable from the thread the driver reports debug messages on
+         *
+         * @param name      a string literal such as "VertexBuffer::update"
+         * @param object    the OpenGL name of the object it works on
+         */
+        void set_operation(const char* name,unsigned int object) noexcept
+        {
+            operation.store(name,std::memory_order_relaxed);
+            operation_object.store(object,std::memory_order_relaxed);
+        }
+
+        const char* get_operation() const noexcept
+        {
+            return operation.load(std::memory_order_relaxed);
+        }
+
+        unsigned int get_operation_object() const noexcept
+        {
+            return operation_object.load(std::memory_order_relaxed);
+        }
+
+#ifdef GLAD_INSTRUMENT
+        CallAccounting& get_call_accounting() noexcept
+        {
+            return accounting;
+        }
+#endif
+    };
+
+    /**
+     * @brief the status cache of the current OpenGL context
+     *
+     * @return StatusCache&
+     */
+    inline StatusCache& status_cache() noexcept
+    {
+        return Context::get_current().get_status_cache();
+    }
+
+    /**
+     * @brief remember the glbind operation that is about to call OpenGL on the current Context
+     *
+     * @param name      a string literal such as "VertexBuffer::update"
+     * @param object    the OpenGL name of the object it works on
+     */
+    inline void set_operation(const char* name,unsigned int object = 0) noexcept
+    {
+        Context::get_current().set_operation(name,object);
+    }
+
+    /**
+     * @brief how many binds glbind skipped because the object was already bound
+     *
+     * @return std::size_t
+     */
+    inline std::size_t get_skipped_bind_count() noexcept
+    {
+        return status_cache().get_skipped_bind_count();
+    }
+
+    /**
+     * @brief how many state changes glbind skipped because OpenGL already held the value
+     *
+     * @return std::size_t
+     */
+    inline std::size_t get_skipped_state_count() noexcept
+    {
+        return status_cache().get_skipped_state_count();
+    }
+
+    /**
+     * @brief re-query the OpenGL status, call it after changing the status with raw OpenGL calls
+     *
+     */
+    inline void sync_status() noexcept
+    {
+        status_cache().sync();
+    }
+
+#ifdef GLAD_INSTRUMENT
+    /**
+     * @brief the call counters of the current OpenGL context
+     *
+     * @return CallAccounting&
+     */
+    inline CallAccounting& call_accounting() noexcept
+    {
+        return Context::get_current().get_call_accounting();
+    }
+
+    /**
+     * @brief start counting every OpenGL call, call it after gladLoadGLLoader()
+     * @note  calls are counted by the Context current on the calling thread
+     *
+     */
+    inline void enable_call_accounting() noexcept
+    {
+        gladInstallCallHook([](int index){call_accounting().count(index);});
+    }
+
+    inline void disable_call_accounting() noexcept
+    {
+        gladUninstallCallHook();
+    }
+
+    /**
+     * @brief attribute the OpenGL calls made during its lifetime to a named section, such as a frame
+     *
+     */
+    class CallSection
+    {
+    public:
+        explicit CallSection(std::string_view name) noexcept(false)
+        {
+            call_accounting().push_section(name);
+        }
+
+        CallSection(CallSection&) = delete;
+
+        ~CallSection() noexcept
+        {
+            call_accounting().pop_section();
+        }
+    };
+#endif
+}
\ No newline at end of file
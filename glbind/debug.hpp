@@ -0,0 +1,228 @@
+#pragma once
+
+#include "context.hpp"
+#include "ring_buffer.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+namespace graphics
+{
+    /**
+     * @brief KHR_debug tokens and entry point, glad is generated for OpenGL 3.3 without extensions
+     *
+     */
+    namespace khr_debug
+    {
+        constexpr GLenum debug_output {0x92E0};
+        constexpr GLenum debug_output_synchronous {0x8242};
+        constexpr GLenum debug_source_api {0x8246};
+        constexpr GLenum debug_type_error {0x824C};
+        constexpr GLenum debug_severity_high {0x9146};
+        constexpr GLenum debug_severity_notification {0x826B};
+
+        using DebugProc = void (APIENTRY*)(GLenum source,GLenum type,GLuint id,GLenum severity,GLsizei length,const GLchar* message,const void* user_param);
+        using DebugMessageCallbackProc = void (APIENTRY*)(DebugProc callback,const void* user_param);
+    }
+
+    /**
+     * @brief one OpenGL error or debug message, blamed on the last glbind operation before it
+     *
+     */
+    struct GLMessage
+    {
+        GLenum source;
+        GLenum type;
+        GLuint id;                      // the error code for messages polled from glGetError
+        GLenum severity;
+        const char* operation;          // nullptr if glbind had not called OpenGL yet
+        unsigned int object;
+        std::array<char,256> text;      // truncated, always null terminated
+
+        std::string_view get_text() const noexcept
+        {
+            return text.data();
+        }
+    };
+
+    /**
+     * @brief collect OpenGL errors without a sync point after each call
+     * @note  uses the KHR_debug callback when the context has it (OpenGL 4.3, GL_KHR_debug or GL_ARB_debug_output),
+     *        otherwise glGetError is polled in one batch by drain(). either way messages wait in a lock-free
+     *        ring buffer until drain() is called, once per frame is enough
+     * @warning create it on the thread of the OpenGL context it watches, after gladLoadGLLoader()
+     */
+    class ErrorCollector
+    {
+    public:
+        static constexpr std::size_t message_capacity {256};
+        static constexpr std::size_t max_polled_errors {16};
+
+    private:
+        Context& context;
+        khr_debug::DebugMessageCallbackProc debug_message_callback {nullptr};
+        RingBuffer<GLMessage,message_capacity> messages;
+        std::atomic<std::size_t> dropped_count {0};
+        std::atomic<bool> keep_notifications {false};
+
+        static bool has_extension(std::string_view name) noexcept
+        {
+            int count {0};
+            glGetIntegerv(GL_NUM_EXTENSIONS,&count);
+            for(int i = 0;i < count;i++)
+            {
+                const char* extension {reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS,i))};
+                if(extension != nullptr && name == extension)
+                    return true;
+            }
+            return false;
+        }
+
+        static std::string_view error_name(GLenum error) noexcept
+        {
+            switch(error)
+            {
+            case GL_INVALID_ENUM:
+                return "GL_INVALID_ENUM";
+            case GL_INVALID_VALUE:
+                return "GL_INVALID_VALUE";
+            case GL_INVALID_OPERATION:
+                return "GL_INVALID_OPERATION";
+            case GL_INVALID_FRAMEBUFFER_OPERATION:
+                return "GL_INVALID_FRAMEBUFFER_OPERATION";
+            case GL_OUT_OF_MEMORY:
+                return "GL_OUT_OF_MEMORY";
+            default:
+                return "unknown OpenGL error";
+            }
+        }
+
+        void push(GLenum source,GLenum type,GLuint id,GLenum severity,std::string_view text) noexcept
+        {
+            GLMessage message {source,type,id,severity,context.get_operation(),context.get_operation_object(),{}};
+            const std::size_t len {std::min(text.size(),message.text.size() - 1)};
+            std::memcpy(message.text.data(),text.data(),len);
+            message.text[len] = '\0';
+
+            if(!messages.push(message))
+                dropped_count.fetch_add(1,std::memory_order_relaxed);
+        }
+
+        static void APIENTRY debug_callback(GLenum source,GLenum type,GLuint id,GLenum severity,GLsizei length,const GLchar* message,const void* user_param) noexcept
+        {
+            auto& collector {*static_cast<ErrorCollector*>(const_cast<void*>(user_param))};
+            if(severity == khr_debug::debug_severity_notification && !collector.keep_notifications.load(std::memory_order_relaxed))
+                return;
+            const std::string_view text {message,length < 0 ? std::strlen(message) : static_cast<std::size_t>(length)};
+            collector.push(source,type,id,severity,text);
+        }
+
+        void poll_errors() noexcept
+        {
+            for(std::size_t i = 0;i < max_polled_errors;i++)
+            {
+                const GLenum error {glGetError()};
+                if(error == GL_NO_ERROR)
+                    break;
+                push(khr_debug::debug_source_api,khr_debug::debug_type_error,error,khr_debug::debug_severity_high,error_name(error));
+            }
+        }
+
+    public:
+        /**
+         * @brief start collecting the errors of the current OpenGL context
+         *
+         * @param load          the loader given to gladLoadGLLoader(), used to find the KHR_debug entry point
+         * @param synchronous   report debug messages on the thread that made the call, exact blame but
+         *                      slower drivers. ignored when glGetError is polled
+         */
+        explicit ErrorCollector(GLADloadproc load,bool synchronous = false) noexcept
+            : context {Context::get_current()}
+        {
+            const bool khr {GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 3) || has_extension("GL_KHR_debug")};
+            if(khr)
+                debug_message_callback = reinterpret_cast<khr_debug::DebugMessageCallbackProc>(load("glDebugMessageCallback"));
+            else if(has_extension("GL_ARB_debug_output"))
+                debug_message_callback = reinterpret_cast<khr_debug::DebugMessageCallbackProc>(load("glDebugMessageCallbackARB"));
+
+            if(debug_message_callback == nullptr)
+                return;
+
+            // ARB_debug_output only reports in debug contexts and has no GL_DEBUG_OUTPUT switch
+            if(khr)
+                glEnable(khr_debug::debug_output);
+            if(synchronous)
+                glEnable(khr_debug::debug_output_synchronous);
+            debug_message_callback(&debug_callback,this);
+        }
+
+        ErrorCollector(ErrorCollector&) = delete;
+
+        ~ErrorCollector() noexcept
+        {
+            if(debug_message_callback != nullptr)
+                debug_message_callback(nullptr,nullptr);
+        }
+
+        /**
+         * @brief whether messages come from the KHR_debug callback instead of glGetError
+         *
+         * @return true
+         * @return false
+         */
+        bool has_debug_output() const noexcept
+        {
+            return debug_message_callback != nullptr;
+        }
+
+        /**
+         * @brief also collect GL_DEBUG_SEVERITY_NOTIFICATION messages, they are dropped by default
+         *
+         * @param keep
+         */
+        void set_keep_notifications(bool keep) noexcept
+        {
+            keep_notifications.store(keep,std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief how many messages were dropped because nobody drained the ring buffer in time
+         *
+         * @return std::size_t
+         */
+        std::size_t get_dropped_count() const noexcept
+        {
+            return dropped_count.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief hand every collected message to handler, polls glGetError first when there is no debug output
+         * @note  call it on the thread of the OpenGL context, once per frame
+         *
+         * @tparam Handler  invocable with const GLMessage&
+         * @param handler
+         * @return std::size_t the number of messages handled
+         */
+        template <std::invocable<const GLMessage&> Handler>
+        std::size_t drain(Handler&& handler) noexcept(noexcept(handler(std::declval<const GLMessage&>())))
+        {
+            if(debug_message_callback == nullptr)
+                poll_errors();
+
+            std::size_t count {0};
+            GLMessage message;
+            while(messages.pop(message))
+            {
+                handler(message);
+                ++count;
+            }
+            return count;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace graphics
+{
+    /**
+     * @brief half-open range [begin,end) of elements in a buffer
+     *
+     */
+    struct DirtyRange
+    {
+        std::size_t begin;
+        std::size_t end;
+
+        std::size_t get_len() const noexcept
+        {
+            return end - begin;
+        }
+    };
+
+    /**
+     * @brief sorted set of dirty ranges, overlapping and close ranges are merged as they are marked
+     * @note  ranges closer than merge_gap elements are merged too, one bigger upload is cheaper
+     *        than several tiny ones
+     * @warning a merged range covers the elements of the gap, only use a gap when they hold valid data
+     *
+     */
+    class DirtyRanges
+    {
+    private:
+        std::vector<DirtyRange> ranges;
+        std::size_t merge_gap;
+
+    public:
+        explicit DirtyRanges(std::size_t merge_gap = 0) noexcept
+            : merge_gap(merge_gap)
+        {
+        }
+
+        /**
+         * @brief mark [begin,end) dirty
+         *
+         * @param begin
+         * @param end
+         */
+        void mark(std::size_t begin,std::size_t end) noexcept(false)
+        {
+            if(begin >= end)
+                return;
+
+            // first range that reaches begin, and the first one that starts after end
+            auto first {std::lower_bound(ranges.begin(),ranges.end(),begin,[&](const DirtyRange& range,std::size_t value)
+            {
+                return range.end + merge_gap < value;
+            })};
+            auto last {first};
+            while(last != ranges.end() && last->begin <= end + merge_gap)
+            {
+                begin = std::min(begin,last->begin);
+                end = std::max(end,last->end);
+                ++last;
+            }
+
+            if(first == last)
+                ranges.insert(first,DirtyRange {begin,end});
+            else
+            {
+                *first = DirtyRange {begin,end};
+                ranges.erase(first + 1,last);
+            }
+        }
+
+        void clear() noexcept
+        {
+            ranges.clear();
+        }
+
+        bool empty() const noexcept
+        {
+            return ranges.empty();
+        }
+
+        std::span<const DirtyRange> get_ranges() const noexcept
+        {
+            return ranges;
+        }
+
+        /**
+         * @brief Get the number of elements covered by the dirty ranges
+         *
+         * @return std::size_t
+         */
+        std::size_t get_dirty_len() const noexcept
+        {
+            std::size_t len {0};
+            for(const auto& range : ranges)
+                len += range.get_len();
+            return len;
+        }
+    };
+
+    /**
+     * @brief CPU copy of the writes made to a buffer since its last flush
+     * @note  only the dirty ranges of the copy hold written data, so only ranges that touch or overlap
+     *        are merged: the elements between two writes are never uploaded
+     *
+     * @tparam T element type
+     */
+    template <typename T>
+    class StagedWrites
+    {
+    private:
+        std::vector<T> staging;
+        DirtyRanges dirty;
+
+    public:
+        /**
+         * @brief copy data at offset, into a buffer of len elements
+         * @warning throw std::out_of_range when data does not fit in len
+         *
+         * @param offset    by count
+         * @param data
+         * @param len       the size of the buffer, by count
+         */
+        void write(std::size_t offset,std::span<const T> data,std::size_t len) noexcept(false)
+        {
+            if(offset > len || data.size() > len - offset)
+                throw std::out_of_range("write out of buffer range");
+            if(data.empty())
+                return;
+
+            if(staging.size() < len)
+                staging.resize(len);
+            std::copy(data.begin(),data.end(),staging.begin() + offset);
+            dirty.mark(offset,offset + data.size());
+        }
+
+        /**
+         * @brief hand each dirty range to upload, then forget them
+         *
+         * @tparam Upload invocable with (std::size_t offset,std::span<const T> data)
+         * @param upload
+         */
+        template <typename Upload>
+        void flush(Upload&& upload)
+        {
+            for(const auto& range : dirty.get_ranges())
+                upload(range.begin,std::span<const T>(staging).subspan(range.begin,range.get_len()));
+            dirty.clear();
+        }
+
+        /**
+         * @brief drop the writes not flushed yet
+         *
+         */
+        void discard() noexcept
+        {
+            dirty.clear();
+        }
+
+        bool empty() const noexcept
+        {
+            return dirty.empty();
+        }
+
+        const DirtyRanges& get_dirty_ranges() const noexcept
+        {
+            return dirty;
+        }
+    };
+}
\ No newline at end of file
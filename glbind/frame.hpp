@@ -31,17 +31,18 @@ namespace graphics
         Frame(T& t) noexcept(false)
             : texture(t)
         {
-            Scope([&]()
+            RestoreScope<State::Framebuffer | State::Renderbuffer>([&]()
             {
                 glGenFramebuffers(1,&fbo_id);
-                glBindFramebuffer(GL_FRAMEBUFFER,fbo_id);
+                set_operation("Frame::Frame",fbo_id);
+                status_cache().bind_framebuffer(GL_FRAMEBUFFER,fbo_id);
 
                 // bind texture to fbo
                 glFramebufferTexture2D(GL_FRAMEBUFFER,GL_COLOR_ATTACHMENT0,GL_TEXTURE_2D,texture.get_texture_id(),0);
 
                 // create rbo
                 glGenRenderbuffers(1,&rbo_id);
-                glBindRenderbuffer(GL_RENDERBUFFER,rbo_id);
+                status_cache().bind_renderbuffer(rbo_id);
                 glRenderbufferStorage(GL_RENDERBUFFER,GL_DEPTH24_STENCIL8,texture.get_width(),texture.get_height());
 
                 // bind rbo to fbo
@@ -65,8 +66,8 @@ namespace graphics
          */
         ~Frame() noexcept
         {
-            glDeleteRenderbuffers(1,&rbo_id);
-            glDeleteFramebuffers(1,&fbo_id);
+            status_cache().delete_renderbuffer(rbo_id);
+            status_cache().delete_framebuffer(fbo_id);
         }
 
         /**
@@ -75,7 +76,7 @@ namespace graphics
          */
         void use() const noexcept
         {
-            glBindFramebuffer(GL_FRAMEBUFFER,fbo_id);
+            status_cache().bind_framebuffer(GL_FRAMEBUFFER,fbo_id);
         }
 
         /**
@@ -84,7 +85,7 @@ namespace graphics
          */
         void use_as_out() const noexcept
         {
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER,fbo_id);
+            status_cache().bind_framebuffer(GL_DRAW_FRAMEBUFFER,fbo_id);
         }
 
         /**
@@ -93,7 +94,7 @@ namespace graphics
          */
         void use_as_read() const noexcept
         {
-            glBindFramebuffer(GL_READ_FRAMEBUFFER,fbo_id);
+            status_cache().bind_framebuffer(GL_READ_FRAMEBUFFER,fbo_id);
         }
 
         /**
@@ -138,7 +139,7 @@ namespace graphics
 
         void fill_color(float r,float g,float b,float a) const noexcept
         {
-            Scope([&]()
+            RestoreScope<State::Framebuffer>([&]()
             {
                 use();
                 glClearColor(r,g,b,a);
@@ -147,7 +148,7 @@ namespace graphics
 
         void clear_color_buffer() const noexcept
         {
-            Scope([&]()
+            RestoreScope<State::Framebuffer>([&]()
             {
                 use();
                 glClear(GL_COLOR_BUFFER_BIT);
@@ -156,7 +157,7 @@ namespace graphics
 
         void clear_stencil_buffer() const noexcept
         {
-            Scope([&]()
+            RestoreScope<State::Framebuffer>([&]()
             {
                 use();
                 glClear(GL_STENCIL_BUFFER_BIT);
@@ -165,7 +166,7 @@ namespace graphics
 
         void clear_depth_buffer() const noexcept
         {
-            Scope([&]()
+            RestoreScope<State::Framebuffer>([&]()
             {
                 use();
                 glClear(GL_DEPTH_BUFFER_BIT);
@@ -180,36 +181,32 @@ namespace graphics
 
         static void use() noexcept
         {
-            glBindFramebuffer(GL_FRAMEBUFFER,0);
+            status_cache().bind_framebuffer(GL_FRAMEBUFFER,0);
         }
 
         static void use_as_read() noexcept
         {
-            glBindFramebuffer(GL_READ_FRAMEBUFFER,0);
+            status_cache().bind_framebuffer(GL_READ_FRAMEBUFFER,0);
         }
 
         static void use_as_out() noexcept
         {
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER,0);
+            status_cache().bind_framebuffer(GL_DRAW_FRAMEBUFFER,0);
         }
 
         static unsigned int get_width() noexcept
         {
-            int dims[4];
-            glGetIntegerv(GL_VIEWPORT,dims);
-            return dims[2];
+            return status_cache().get().viewport[2];
         }
 
         static unsigned int get_height() noexcept
         {
-            int dims[4];
-            glGetIntegerv(GL_VIEWPORT,dims);
-            return dims[3];
+            return status_cache().get().viewport[3];
         }
 
         static void fill_color(float r,float g,float b,float a) noexcept
         {
-            Scope([&]()
+            RestoreScope<State::Framebuffer>([&]()
             {
                 use();
                 glClearColor(r,g,b,a);
@@ -218,7 +215,7 @@ namespace graphics
 
         static void clear_color_buffer() noexcept
         {
-            Scope([&]()
+            RestoreScope<State::Framebuffer>([&]()
             {
                 use();
                 glClear(GL_COLOR_BUFFER_BIT);
@@ -227,7 +224,7 @@ namespace graphics
 
         static void clear_stencil_buffer() noexcept
         {
-            Scope([&]()
+            RestoreScope<State::Framebuffer>([&]()
             {
                 use();
                 glClear(GL_STENCIL_BUFFER_BIT);
@@ -236,7 +233,7 @@ namespace graphics
 
         static void clear_depth_buffer() noexcept
         {
-            Scope([&]()
+            RestoreScope<State::Framebuffer>([&]()
             {
                 use();
                 glClear(GL_DEPTH_BUFFER_BIT);
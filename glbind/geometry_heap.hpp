@@ -0,0 +1,299 @@
+#pragma once
+
+#include "primitive.hpp"
+#include "range_allocator.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graphics
+{
+    /**
+     * @brief where a mesh lives in a GeometryHeap
+     *
+     */
+    struct GeometryHandle
+    {
+        std::uint32_t page {0};
+        RangeAllocator::Allocation vertices;    // by vertex
+        RangeAllocator::Allocation indices;     // by index
+
+        bool is_valid() const noexcept
+        {
+            return vertices.is_valid();
+        }
+
+        /**
+         * @brief Get the value added to every index of the mesh, the base vertex of glDrawElementsBaseVertex
+         *
+         * @return int
+         */
+        int get_base_vertex() const noexcept
+        {
+            return static_cast<int>(vertices.offset);
+        }
+
+        std::size_t get_first_index() const noexcept
+        {
+            return indices.offset;
+        }
+
+        std::size_t get_index_count() const noexcept
+        {
+            return indices.size;
+        }
+    };
+
+    /**
+     * @brief many meshes of one vertex format in a few large buffers
+     * @note  each page is one vbo, one ebo and one vao, ranges in them are given out by a RangeAllocator.
+     *        indices stay relative to their mesh, meshes of one page are drawn with the same vao through
+     *        glDrawElementsBaseVertex, so drawing them one after the other binds nothing.
+     *        indices are stored in the narrowest type a page of vertices needs, 16 bits by default
+     *
+     */
+    class GeometryHeap
+    {
+    private:
+        struct Page
+        {
+            unsigned int vbo_id;
+            unsigned int ebo_id;
+            unsigned int vao_id;
+            RangeAllocator vertices;
+            RangeAllocator indices;
+        };
+
+        std::size_t vertex_len;
+        std::vector<VertexAttrib> attribs;
+        std::size_t page_vertex_count;
+        std::size_t page_index_count;
+        GLenum index_type;
+        std::vector<Page> pages;
+
+        static void upload(unsigned int buffer_id,std::size_t offset,std::size_t size,const void* data) noexcept
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER,buffer_id);
+            glBufferSubData(GL_COPY_WRITE_BUFFER,offset,size,data);
+        }
+
+        Page& add_page() noexcept(false)
+        {
+            Page& page {pages.emplace_back(Page {0,0,0,RangeAllocator(page_vertex_count),RangeAllocator(page_index_count)})};
+            glGenBuffers(1,&page.vbo_id);
+            glGenBuffers(1,&page.ebo_id);
+            glGenVertexArrays(1,&page.vao_id);
+            set_operation("GeometryHeap::add_page",page.vao_id);
+
+            glBindBuffer(GL_COPY_WRITE_BUFFER,page.vbo_id);
+            glBufferData(GL_COPY_WRITE_BUFFER,page_vertex_count * vertex_len * sizeof(float),nullptr,GL_STATIC_DRAW);
+            glBindBuffer(GL_COPY_WRITE_BUFFER,page.ebo_id);
+            glBufferData(GL_COPY_WRITE_BUFFER,page_index_count * index_size(index_type),nullptr,GL_STATIC_DRAW);
+
+            RestoreScope<State::VertexArray | State::ArrayBuffer>([&]()
+            {
+                status_cache().bind_vertex_array(page.vao_id);
+                status_cache().bind_buffer(GL_ARRAY_BUFFER,page.vbo_id);
+                // the ebo binding belongs to the vao, it stays after the Scope
+                status_cache().bind_buffer(GL_ELEMENT_ARRAY_BUFFER,page.ebo_id);
+                for(const auto& attrib : attribs)
+                {
+                    glVertexAttribPointer(attrib.index,attrib.len,GL_FLOAT,attrib.normalized,vertex_len * sizeof(float),(void*)(attrib.offset * sizeof(float)));
+                    glEnableVertexAttribArray(attrib.index);
+                }
+            });
+            return page;
+        }
+
+        static bool try_allocate(Page& page,std::size_t vertex_count,std::size_t index_count,GeometryHandle& handle) noexcept(false)
+        {
+            handle.vertices = page.vertices.allocate(vertex_count);
+            if(!handle.vertices.is_valid())
+                return false;
+            handle.indices = page.indices.allocate(index_count);
+            if(!handle.indices.is_valid())
+            {
+                page.vertices.free(handle.vertices);
+                handle.vertices = {};
+                return false;
+            }
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Construct a new Geometry Heap object, pages are created when needed
+         *
+         * @param vertex_len        the lenth of a single vertex data (by count)
+         * @param attribs           the vertex format shared by every mesh
+         * @param page_vertex_count vertices in one page
+         * @param page_index_count  indices in one page
+         */
+        GeometryHeap(std::size_t vertex_len,std::vector<VertexAttrib> attribs,std::size_t page_vertex_count = 1 << 16,std::size_t page_index_count = 1 << 20) noexcept
+            : vertex_len(vertex_len),attribs(std::move(attribs)),page_vertex_count(page_vertex_count),page_index_count(page_index_count),
+              index_type(index_type_for(page_vertex_count))
+        {
+        }
+
+        /**
+         * @brief GeometryHeap can't be copied
+         *
+         */
+        GeometryHeap(GeometryHeap&) = delete;
+
+        ~GeometryHeap() noexcept
+        {
+            for(const auto& page : pages)
+            {
+                status_cache().delete_vertex_array(page.vao_id);
+                status_cache().delete_buffer(page.ebo_id);
+                status_cache().delete_buffer(page.vbo_id);
+            }
+        }
+
+        /**
+         * @brief copy a mesh into the heap
+         * @warning throw std::runtime_error when the mesh is larger than a page or an index is out of its vertices
+         *
+         * @param vertices  vertex_len floats per vertex
+         * @param indices   relative to the first vertex of the mesh
+         * @return GeometryHandle
+         */
+        GeometryHandle add(std::span<const float> vertices,std::span<const unsigned int> indices) noexcept(false)
+        {
+            const std::size_t vertex_count {vertices.size() / vertex_len};
+            if(vertex_count == 0 || indices.empty())
+                throw std::runtime_error("GeometryHeap can't hold an empty mesh");
+            if(vertex_count > page_vertex_count || indices.size() > page_index_count)
+                throw std::runtime_error("mesh is larger than a GeometryHeap page");
+            if(*std::max_element(indices.begin(),indices.end()) >= vertex_count)
+                throw std::runtime_error("mesh index out of its vertices");
+
+            GeometryHandle handle;
+            for(handle.page = 0;handle.page < pages.size();handle.page++)
+            {
+                if(try_allocate(pages[handle.page],vertex_count,indices.size(),handle))
+                    break;
+            }
+            if(handle.page == pages.size())
+                try_allocate(add_page(),vertex_count,indices.size(),handle);
+
+            const Page& page {pages[handle.page]};
+            set_operation("GeometryHeap::add",page.vao_id);
+            upload(page.vbo_id,handle.vertices.offset * vertex_len * sizeof(float),vertex_count * vertex_len * sizeof(float),vertices.data());
+            const std::vector<std::byte> bytes {narrow_indices(indices,index_type)};
+            upload(page.ebo_id,handle.indices.offset * index_size(index_type),bytes.size(),bytes.data());
+            return handle;
+        }
+
+        /**
+         * @brief give the ranges of a mesh back to its page, the handle must not be drawn anymore
+         *
+         * @param handle
+         */
+        void remove(GeometryHandle& handle) noexcept
+        {
+            if(!handle.is_valid())
+                return;
+            pages[handle.page].vertices.free(handle.vertices);
+            pages[handle.page].indices.free(handle.indices);
+            handle = {};
+        }
+
+        unsigned int get_vao_id(const GeometryHandle& handle) const noexcept
+        {
+            return pages[handle.page].vao_id;
+        }
+
+        unsigned int get_ebo_id(const GeometryHandle& handle) const noexcept
+        {
+            return pages[handle.page].ebo_id;
+        }
+
+        GLenum get_index_type() const noexcept
+        {
+            return index_type;
+        }
+
+        std::size_t get_page_count() const noexcept
+        {
+            return pages.size();
+        }
+
+        std::size_t get_vertex_len() const noexcept
+        {
+            return vertex_len;
+        }
+    };
+
+    /**
+     * @brief draw a mesh of a GeometryHeap, sort draws by page to bind as little as possible
+     *
+     * @tparam primitive
+     * @note  leaves the status as it found it, see draw_states
+     * @warning primitive restart is left as the caller set it, keep it off while the meshes use the largest index value
+     * @param heap
+     * @param handle
+     */
+    template <Primitives primitive>
+    inline void draw(const GeometryHeap& heap,const GeometryHandle& handle) noexcept
+    {
+        Context& context {Context::get_current()};
+        context.set_operation("draw",heap.get_vao_id(handle));
+        StatusCache& cache {context.get_status_cache()};
+        const StatusRestorer<draw_states> restorer;
+        cache.bind_vertex_array(heap.get_vao_id(handle));
+        cache.bind_buffer(GL_ELEMENT_ARRAY_BUFFER,heap.get_ebo_id(handle));
+        glDrawElementsBaseVertex(static_cast<int>(primitive),handle.get_index_count(),heap.get_index_type(),
+            (void*)(handle.get_first_index() * index_size(heap.get_index_type())),handle.get_base_vertex());
+    }
+
+    /**
+     * @brief draw many meshes of a GeometryHeap, one glMultiDrawElementsBaseVertex per page
+     *
+     * @tparam primitive
+     * @note  leaves the status as it found it, see draw_states
+     * @warning primitive restart is left as the caller set it, keep it off while the meshes use the largest index value
+     * @param heap
+     * @param handles
+     */
+    template <Primitives primitive>
+    inline void multi_draw(const GeometryHeap& heap,std::span<const GeometryHandle> handles) noexcept(false)
+    {
+        thread_local std::vector<const GeometryHandle*> sorted;
+        thread_local DrawBatch batch;
+
+        sorted.clear();
+        for(const auto& handle : handles)
+            sorted.push_back(&handle);
+        std::stable_sort(sorted.begin(),sorted.end(),[](const GeometryHandle* a,const GeometryHandle* b)
+        {
+            return a->page < b->page;
+        });
+
+        Context& context {Context::get_current()};
+        StatusCache& cache {context.get_status_cache()};
+        const StatusRestorer<draw_states> restorer;
+        for(auto begin {sorted.begin()};begin != sorted.end();)
+        {
+            const auto end {std::find_if(begin,sorted.end(),[&](const GeometryHandle* handle){return handle->page != (*begin)->page;})};
+            batch.clear();
+            batch.set_index_type(heap.get_index_type());
+            for(auto it {begin};it != end;++it)
+                batch.add((*it)->get_first_index(),(*it)->get_index_count(),(*it)->get_base_vertex());
+
+            const unsigned int vao_id {heap.get_vao_id(**begin)};
+            context.set_operation("multi_draw",vao_id);
+            cache.bind_vertex_array(vao_id);
+            cache.bind_buffer(GL_ELEMENT_ARRAY_BUFFER,heap.get_ebo_id(**begin));
+            glMultiDrawElementsBaseVertex(static_cast<int>(primitive),batch.get_counts().data(),heap.get_index_type(),
+                batch.get_offsets().data(),static_cast<GLsizei>(batch.size()),batch.get_base_vertices().data());
+            begin = end;
+        }
+    }
+}
\ No newline at end of file
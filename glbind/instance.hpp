@@ -0,0 +1,51 @@
+#pragma once
+
+#include "vertex.hpp"
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <array>
+#include <cstring>
+
+namespace graphics
+{
+    /**
+     * @brief a mat4 per instance, read in GLSL as "layout (location = location) in mat4"
+     * @note  takes the four locations from location to location + 3, one per column
+     *
+     * @tparam location
+     */
+    template <unsigned int location>
+    struct InstanceTransform
+    {
+        std::array<float,4> column0;
+        std::array<float,4> column1;
+        std::array<float,4> column2;
+        std::array<float,4> column3;
+
+        using Layout = VertexLayout<
+            Attrib<location,&InstanceTransform::column0>,
+            Attrib<location + 1,&InstanceTransform::column1>,
+            Attrib<location + 2,&InstanceTransform::column2>,
+            Attrib<location + 3,&InstanceTransform::column3>>;
+
+        InstanceTransform() noexcept = default;
+
+        InstanceTransform(const glm::mat4& matrix) noexcept
+        {
+            const float* data {glm::value_ptr(matrix)};
+            std::memcpy(column0.data(),data,sizeof(column0));
+            std::memcpy(column1.data(),data + 4,sizeof(column1));
+            std::memcpy(column2.data(),data + 8,sizeof(column2));
+            std::memcpy(column3.data(),data + 12,sizeof(column3));
+        }
+    };
+
+    /**
+     * @brief per-instance transforms, enable it with VertexArray::enable_instance_layout()
+     *        and draw with draw_instanced()
+     *
+     * @tparam location the first of the four locations of the mat4
+     */
+    template <unsigned int location>
+    using TransformBuffer = StructVertexBuffer<InstanceTransform<location>,BufferType::Dynamic>;
+}
\ No newline at end of file
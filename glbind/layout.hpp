@@ -0,0 +1,279 @@
+#pragma once
+
+#include "scope.hpp"
+#include <glad/glad.h>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+namespace graphics
+{
+    /**
+     * @brief IEEE 754 half precision float, as stored in a vertex buffer
+     *
+     */
+    struct Half
+    {
+        std::uint16_t bits {0};
+
+        constexpr Half() noexcept = default;
+
+        /**
+         * @brief convert from float, rounding to nearest even
+         *
+         * @param value
+         */
+        constexpr Half(float value) noexcept
+        {
+            const std::uint32_t f {std::bit_cast<std::uint32_t>(value)};
+            const std::uint32_t sign {(f >> 16) & 0x8000};
+            const std::uint32_t abs {f & 0x7FFFFFFF};
+
+            if(abs >= 0x7F800000)
+            {
+                // inf stays inf, nan stays a quiet nan
+                bits = static_cast<std::uint16_t>(sign | 0x7C00 | (abs > 0x7F800000 ? 0x0200 : 0));
+                return;
+            }
+            if(abs >= 0x477FF000)
+            {
+                // rounds past 65504
+                bits = static_cast<std::uint16_t>(sign | 0x7C00);
+                return;
+            }
+            if(abs < 0x38800000)
+            {
+                // subnormal half, or zero
+                const std::uint32_t shift {113 - (abs >> 23)};
+                if(shift > 11)
+                {
+                    bits = static_cast<std::uint16_t>(sign);
+                    return;
+                }
+                const std::uint32_t mantissa {(abs & 0x7FFFFF) | 0x800000};
+                std::uint32_t half {mantissa >> (shift + 13)};
+                const std::uint32_t rest {mantissa & ((std::uint32_t(1) << (shift + 13)) - 1)};
+                const std::uint32_t halfway {std::uint32_t(1) << (shift + 12)};
+                if(rest > halfway || (rest == halfway && (half & 1)))
+                    ++half;
+                bits = static_cast<std::uint16_t>(sign | half);
+                return;
+            }
+
+            std::uint32_t half {(abs - 0x38000000) >> 13};
+            const std::uint32_t rest {abs & 0x1FFF};
+            if(rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+                ++half;
+            bits = static_cast<std::uint16_t>(sign | half);
+        }
+
+        constexpr operator float() const noexcept
+        {
+            const std::uint32_t sign {static_cast<std::uint32_t>(bits & 0x8000) << 16};
+            const std::uint32_t exponent {(bits >> 10) & 0x1Fu};
+            const std::uint32_t mantissa {bits & 0x3FFu};
+
+            if(exponent == 0x1F)
+                return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+            if(exponent != 0)
+                return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+
+            const float value {static_cast<float>(mantissa) / 16777216.0f};
+            return sign != 0 ? -value : value;
+        }
+
+        constexpr bool operator==(const Half&) const noexcept = default;
+    };
+
+    /**
+     * @brief four signed components packed in 32 bits (x,y,z 10 bits, w 2 bits), GL_INT_2_10_10_10_REV
+     *
+     */
+    struct Int2101010
+    {
+        std::uint32_t bits {0};
+
+        constexpr bool operator==(const Int2101010&) const noexcept = default;
+    };
+
+    /**
+     * @brief how the shader sees an attribute
+     *
+     */
+    enum class AttribMode
+    {
+        Float,          // converted to float as is, glVertexAttribPointer
+        Normalized,     // integers mapped to [0,1] or [-1,1], glVertexAttribPointer
+        Integer         // kept integer (ivec/uvec in GLSL), glVertexAttribIPointer
+    };
+
+    /**
+     * @brief the OpenGL type of one component
+     *
+     * @tparam T
+     */
+    template <typename T>
+    struct ComponentType;
+
+    template <> struct ComponentType<float>         {static constexpr GLenum value {GL_FLOAT};};
+    template <> struct ComponentType<Half>          {static constexpr GLenum value {GL_HALF_FLOAT};};
+    template <> struct ComponentType<std::int8_t>   {static constexpr GLenum value {GL_BYTE};};
+    template <> struct ComponentType<std::uint8_t>  {static constexpr GLenum value {GL_UNSIGNED_BYTE};};
+    template <> struct ComponentType<std::int16_t>  {static constexpr GLenum value {GL_SHORT};};
+    template <> struct ComponentType<std::uint16_t> {static constexpr GLenum value {GL_UNSIGNED_SHORT};};
+    template <> struct ComponentType<std::int32_t>  {static constexpr GLenum value {GL_INT};};
+    template <> struct ComponentType<std::uint32_t> {static constexpr GLenum value {GL_UNSIGNED_INT};};
+    template <> struct ComponentType<Int2101010>    {static constexpr GLenum value {GL_INT_2_10_10_10_REV};};
+
+    /**
+     * @brief component type and count of a vertex struct member
+     * @note  scalars, std::array and C arrays are known, specialize it for other vector types (such as glm::vec3)
+     *
+     * @tparam T
+     */
+    template <typename T>
+    struct AttribTraits
+    {
+        using component = T;
+        static constexpr std::size_t count {1};
+    };
+
+    template <typename T,std::size_t n>
+    struct AttribTraits<std::array<T,n>>
+    {
+        using component = T;
+        static constexpr std::size_t count {n};
+    };
+
+    template <typename T,std::size_t n>
+    struct AttribTraits<T[n]>
+    {
+        using component = T;
+        static constexpr std::size_t count {n};
+    };
+
+    template <>
+    struct AttribTraits<Int2101010>
+    {
+        using component = Int2101010;
+        static constexpr std::size_t count {4};
+    };
+
+    template <typename T>
+    struct MemberTraits;
+
+    template <typename V,typename M>
+    struct MemberTraits<M V::*>
+    {
+        using vertex = V;
+        using member = M;
+    };
+
+    /**
+     * @brief one attribute of a vertex struct
+     *
+     * @tparam index    the location used in GLSL
+     * @tparam member   pointer to the member, such as &Vertex::position
+     * @tparam mode
+     */
+    template <unsigned int index,auto member,AttribMode mode = AttribMode::Float>
+    struct Attrib
+    {
+        using vertex = typename MemberTraits<decltype(member)>::vertex;
+        using traits = AttribTraits<typename MemberTraits<decltype(member)>::member>;
+        using component = typename traits::component;
+
+        static constexpr unsigned int location {index};
+        static constexpr GLenum type {ComponentType<component>::value};
+        static constexpr std::size_t count {traits::count};
+
+        static_assert(count >= 1 && count <= 4,"vertex attribute must have 1 to 4 components");
+        static_assert(mode != AttribMode::Integer || std::is_integral_v<component>,"integer vertex attribute needs an integer component type");
+        static_assert(mode != AttribMode::Normalized || std::is_integral_v<component> || std::is_same_v<component,Int2101010>,"only integer components can be normalized");
+
+        /**
+         * @brief Get the offset of the member in the vertex, by byte
+         *
+         * @return std::size_t
+         */
+        static std::size_t get_offset() noexcept
+        {
+            static const vertex sample {};
+            return reinterpret_cast<const std::byte*>(&(sample.*member)) - reinterpret_cast<const std::byte*>(&sample);
+        }
+
+        /**
+         * @brief set the attribute pointer of the bound vao and array buffer
+         *
+         */
+        static void enable() noexcept
+        {
+            const void* offset {reinterpret_cast<const void*>(get_offset())};
+            if constexpr(mode == AttribMode::Integer)
+                glVertexAttribIPointer(index,count,type,sizeof(vertex),offset);
+            else
+                glVertexAttribPointer(index,count,type,mode == AttribMode::Normalized,sizeof(vertex),offset);
+            glEnableVertexAttribArray(index);
+        }
+    };
+
+    /**
+     * @brief the attributes of a vertex struct, declare it as the Layout member of the struct
+     *
+     * @tparam Attribs Attrib of the same vertex struct
+     */
+    template <typename... Attribs>
+    struct VertexLayout
+    {
+        static_assert(sizeof...(Attribs) != 0,"VertexLayout needs at least one attribute");
+
+        template <typename V>
+        static constexpr bool describes {(std::is_same_v<typename Attribs::vertex,V> && ...)};
+
+        /**
+         * @brief the i-th attribute, to inspect what was reflected from the vertex struct
+         *
+         * @tparam i
+         */
+        template <std::size_t i>
+        using attrib = std::tuple_element_t<i,std::tuple<Attribs...>>;
+
+        static constexpr std::size_t attrib_count {sizeof...(Attribs)};
+        // the distance between two vertices, by byte
+        static constexpr std::size_t stride {sizeof(typename attrib<0>::vertex)};
+
+        static void enable() noexcept
+        {
+            (Attribs::enable(),...);
+        }
+
+        /**
+         * @brief enable the attributes as per-instance data, they advance once every divisor instances
+         *
+         * @param divisor
+         */
+        static void enable_instanced(unsigned int divisor) noexcept
+        {
+            (Attribs::enable(),...);
+            (glVertexAttribDivisor(Attribs::location,divisor),...);
+        }
+    };
+
+    /**
+     * @brief a standard layout struct with a Layout member type, such as
+     *        struct Vertex {float position[3]; std::uint8_t color[4]; using Layout = VertexLayout<
+     *            Attrib<0,&Vertex::position>,Attrib<1,&Vertex::color,AttribMode::Normalized>>;};
+     *
+     */
+    template <typename V>
+    concept ReflectedVertex = std::is_standard_layout_v<V> && std::is_default_constructible_v<V> && requires
+    {
+        typename V::Layout;
+        V::Layout::enable();
+        requires V::Layout::template describes<V>;
+    };
+}
\ No newline at end of file
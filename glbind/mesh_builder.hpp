@@ -0,0 +1,243 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace graphics
+{
+    /**
+     * @brief turn unindexed vertices into a compact vertex array and an index array, ready for
+     *        VertexBuffer<type> and ElementBuffer<type> under a VertexArrayWithEBO
+     * @note  identical vertices are found with an open addressing hash table. with a weld epsilon, positions
+     *        closer than it on every axis are welded too (the first one wins), the other attributes must still be equal
+     *
+     */
+    class MeshBuilder
+    {
+    private:
+        static constexpr std::uint32_t empty_slot {0xFFFFFFFF};
+
+        std::size_t vertex_len;
+        std::size_t position_offset;
+        float weld_epsilon;
+        std::size_t source_vertex_count {0};
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<std::uint32_t> slots;
+        std::vector<std::uint64_t> hashes;
+
+        using Cell = std::array<std::int64_t,3>;
+
+        static std::uint64_t mix(std::uint64_t hash,std::uint32_t word) noexcept
+        {
+            return (hash ^ word) * 0x100000001B3ull;
+        }
+
+        static std::uint32_t float_bits(float value) noexcept
+        {
+            // -0 and +0 compare equal, so they have to hash equal
+            return std::bit_cast<std::uint32_t>(value == 0.0f ? 0.0f : value);
+        }
+
+        bool is_position(std::size_t i) const noexcept
+        {
+            return weld_epsilon > 0.0f && i >= position_offset && i < position_offset + 3;
+        }
+
+        Cell cell_of(const float* vertex) const noexcept
+        {
+            Cell cell {};
+            if(weld_epsilon > 0.0f)
+            {
+                for(std::size_t axis = 0;axis < 3;axis++)
+                    cell[axis] = static_cast<std::int64_t>(std::floor(vertex[position_offset + axis] / weld_epsilon));
+            }
+            return cell;
+        }
+
+        std::uint64_t hash(const float* vertex,const Cell& cell) const noexcept
+        {
+            std::uint64_t h {0xCBF29CE484222325ull};
+            for(std::size_t i = 0;i < vertex_len;i++)
+            {
+                if(!is_position(i))
+                    h = mix(h,float_bits(vertex[i]));
+            }
+            for(const std::int64_t c : cell)
+            {
+                h = mix(h,static_cast<std::uint32_t>(c));
+                h = mix(h,static_cast<std::uint32_t>(static_cast<std::uint64_t>(c) >> 32));
+            }
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDull;
+            return h ^ (h >> 33);
+        }
+
+        bool same(const float* a,const float* b) const noexcept
+        {
+            for(std::size_t i = 0;i < vertex_len;i++)
+            {
+                if(is_position(i) ? !(std::abs(a[i] - b[i]) <= weld_epsilon) : !(a[i] == b[i]))
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief the vertex equal to vertex in the chain of hash h, or empty_slot
+         *
+         */
+        std::uint32_t find(const float* vertex,std::uint64_t h) const noexcept
+        {
+            const std::size_t mask {slots.size() - 1};
+            for(std::size_t slot = h & mask;slots[slot] != empty_slot;slot = (slot + 1) & mask)
+            {
+                const std::uint32_t candidate {slots[slot]};
+                if(hashes[candidate] == h && same(vertices.data() + std::size_t(candidate) * vertex_len,vertex))
+                    return candidate;
+            }
+            return empty_slot;
+        }
+
+        void insert(std::uint32_t vertex) noexcept
+        {
+            const std::size_t mask {slots.size() - 1};
+            std::size_t slot {hashes[vertex] & mask};
+            while(slots[slot] != empty_slot)
+                slot = (slot + 1) & mask;
+            slots[slot] = vertex;
+        }
+
+        void rehash(std::size_t slot_count) noexcept(false)
+        {
+            slots.assign(slot_count,empty_slot);
+            for(std::uint32_t v = 0;v < hashes.size();v++)
+                insert(v);
+        }
+
+    public:
+        /**
+         * @brief Construct a new Mesh Builder object
+         * @warning throw std::out_of_range when vertex_len is 0, or when welding and the position does not fit in vertex_len
+         *
+         * @param vertex_len        by count
+         * @param weld_epsilon      0 only merges identical vertices
+         * @param position_offset   by count, 3 floats, only used for welding
+         * @param expected_vertices unique vertices to make room for
+         */
+        explicit MeshBuilder(std::size_t vertex_len,float weld_epsilon = 0.0f,std::size_t position_offset = 0,std::size_t expected_vertices = 0) noexcept(false)
+            : vertex_len(vertex_len),position_offset(position_offset),weld_epsilon(weld_epsilon)
+        {
+            if(vertex_len == 0 || (weld_epsilon > 0.0f && position_offset + 3 > vertex_len))
+                throw std::out_of_range("position out of vertex length");
+            vertices.reserve(expected_vertices * vertex_len);
+            hashes.reserve(expected_vertices);
+            slots.assign(std::bit_ceil(std::max<std::size_t>(expected_vertices * 2,16)),empty_slot);
+        }
+
+        /**
+         * @brief add one vertex and index it, reusing an equal vertex when there is one
+         * @warning throw std::runtime_error when vertex is not vertex_len floats
+         *
+         * @param vertex
+         * @return unsigned int the index of the vertex
+         */
+        unsigned int add_vertex(std::span<const float> vertex) noexcept(false)
+        {
+            if(vertex.size() != vertex_len)
+                throw std::runtime_error("vertex length mismatch");
+            ++source_vertex_count;
+
+            const Cell cell {cell_of(vertex.data())};
+            const std::uint64_t h {hash(vertex.data(),cell)};
+            std::uint32_t found {find(vertex.data(),h)};
+            if(found == empty_slot && weld_epsilon > 0.0f)
+            {
+                // a close enough position may sit across a cell border
+                for(std::int64_t dx = -1;dx <= 1 && found == empty_slot;dx++)
+                    for(std::int64_t dy = -1;dy <= 1 && found == empty_slot;dy++)
+                        for(std::int64_t dz = -1;dz <= 1 && found == empty_slot;dz++)
+                        {
+                            if(dx != 0 || dy != 0 || dz != 0)
+                                found = find(vertex.data(),hash(vertex.data(),Cell {cell[0] + dx,cell[1] + dy,cell[2] + dz}));
+                        }
+            }
+
+            if(found == empty_slot)
+            {
+                found = static_cast<std::uint32_t>(hashes.size());
+                vertices.insert(vertices.end(),vertex.begin(),vertex.end());
+                hashes.push_back(h);
+                if(hashes.size() * 2 > slots.size())
+                    rehash(slots.size() * 2);
+                else
+                    insert(found);
+            }
+            indices.push_back(found);
+            return found;
+        }
+
+        /**
+         * @brief add unindexed vertices, such as the data of a plain VertexArray
+         *
+         * @param soup  vertex_len floats per vertex, a trailing partial vertex is ignored
+         */
+        void add_vertices(std::span<const float> soup) noexcept(false)
+        {
+            const std::size_t count {soup.size() / vertex_len};
+            indices.reserve(indices.size() + count);
+            for(std::size_t i = 0;i < count;i++)
+                add_vertex(soup.subspan(i * vertex_len,vertex_len));
+        }
+
+        void clear() noexcept
+        {
+            source_vertex_count = 0;
+            vertices.clear();
+            indices.clear();
+            hashes.clear();
+            slots.assign(slots.size(),empty_slot);
+        }
+
+        std::span<const float> get_vertices() const noexcept
+        {
+            return vertices;
+        }
+
+        std::span<const unsigned int> get_indices() const noexcept
+        {
+            return indices;
+        }
+
+        std::size_t get_vertex_len() const noexcept
+        {
+            return vertex_len;
+        }
+
+        /**
+         * @brief Get the number of unique vertices
+         *
+         * @return std::size_t
+         */
+        std::size_t get_vertex_count() const noexcept
+        {
+            return hashes.size();
+        }
+
+        /**
+         * @brief Get the number of vertices added, before deduplication
+         *
+         * @return std::size_t
+         */
+        std::size_t get_source_vertex_count() const noexcept
+        {
+            return source_vertex_count;
+        }
+    };
+}
\ No newline at end of file
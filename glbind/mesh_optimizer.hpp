@@ -0,0 +1,541 @@
+#pragma once
+
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace graphics
+{
+    /**
+     * @brief how well an index order uses a FIFO post-transform cache
+     *
+     */
+    struct VertexCacheStats
+    {
+        std::size_t vertices_transformed {0};
+        float acmr {0.0f};      // vertices transformed per triangle, 0.5 at best on a regular grid, 3 at worst
+        float atvr {0.0f};      // vertices transformed per referenced vertex, 1 at best
+    };
+
+    /**
+     * @brief simulate a FIFO post-transform cache over a triangle list
+     *
+     * @param indices
+     * @param vertex_count
+     * @param cache_size    16 is close to what most GPUs behave like
+     * @return VertexCacheStats
+     */
+    inline VertexCacheStats analyze_vertex_cache(std::span<const unsigned int> indices,std::size_t vertex_count,std::size_t cache_size = 16) noexcept(false)
+    {
+        VertexCacheStats stats;
+        const std::size_t triangle_count {indices.size() / 3};
+        if(triangle_count == 0)
+            return stats;
+
+        // a vertex is in the cache while fewer than cache_size misses happened since it was loaded
+        std::vector<std::size_t> loaded(vertex_count,0);
+        std::vector<bool> referenced(vertex_count,false);
+        std::size_t referenced_count {0};
+        std::size_t time {cache_size + 1};
+        for(std::size_t i = 0;i < triangle_count * 3;i++)
+        {
+            const unsigned int index {indices[i]};
+            if(index >= vertex_count)
+                throw std::out_of_range("index out of vertex count");
+            if(!referenced[index])
+            {
+                referenced[index] = true;
+                ++referenced_count;
+            }
+            if(time - loaded[index] > cache_size)
+            {
+                loaded[index] = time++;
+                ++stats.vertices_transformed;
+            }
+        }
+        stats.acmr = static_cast<float>(stats.vertices_transformed) / triangle_count;
+        stats.atvr = static_cast<float>(stats.vertices_transformed) / referenced_count;
+        return stats;
+    }
+
+    /**
+     * @brief reorder triangles for the post-transform cache with Forsyth's linear-speed algorithm
+     * @note  it simulates an LRU cache of cache_size, scoring vertices by cache position and remaining triangles
+     * @warning throw std::out_of_range when an index is not below vertex_count
+     *
+     * @param indices       a triangle list, a trailing partial triangle is dropped
+     * @param vertex_count
+     * @param cache_size    at least 4
+     * @return std::vector<unsigned int> the same triangles, reordered
+     */
+    inline std::vector<unsigned int> optimize_vertex_cache(std::span<const unsigned int> indices,std::size_t vertex_count,std::size_t cache_size = 32) noexcept(false)
+    {
+        constexpr float cache_decay_power {1.5f};
+        constexpr float last_triangle_score {0.75f};
+        constexpr float valence_boost_scale {2.0f};
+        constexpr float valence_boost_power {0.5f};
+        constexpr std::size_t none {std::numeric_limits<std::size_t>::max()};
+
+        cache_size = std::max<std::size_t>(cache_size,4);
+        const std::size_t triangle_count {indices.size() / 3};
+        std::vector<unsigned int> result;
+        result.reserve(triangle_count * 3);
+        if(triangle_count == 0)
+            return result;
+
+        // triangles of each vertex, the first live[v] of them are not emitted yet
+        std::vector<std::uint32_t> live(vertex_count,0);
+        for(std::size_t i = 0;i < triangle_count * 3;i++)
+        {
+            if(indices[i] >= vertex_count)
+                throw std::out_of_range("index out of vertex count");
+            ++live[indices[i]];
+        }
+        std::vector<std::uint32_t> offsets(vertex_count + 1,0);
+        std::inclusive_scan(live.begin(),live.end(),offsets.begin() + 1,std::plus<std::uint32_t>());
+        std::vector<std::uint32_t> adjacency(triangle_count * 3);
+        {
+            std::vector<std::uint32_t> cursor(offsets.begin(),offsets.end() - 1);
+            for(std::size_t i = 0;i < triangle_count * 3;i++)
+                adjacency[cursor[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+        }
+
+        std::vector<int> cache_position(vertex_count,-1);
+        std::vector<float> vertex_score(vertex_count);
+        const auto score {[&](unsigned int v)
+        {
+            if(live[v] == 0)
+                return -1.0f;
+            float value {0.0f};
+            const int position {cache_position[v]};
+            if(position >= 0 && position < 3)
+                value = last_triangle_score;
+            else if(position >= 3)
+                value = std::pow(1.0f - static_cast<float>(position - 3) / (cache_size - 3),cache_decay_power);
+            return value + valence_boost_scale * std::pow(static_cast<float>(live[v]),-valence_boost_power);
+        }};
+        const auto triangle_score {[&](std::size_t t)
+        {
+            return vertex_score[indices[t * 3]] + vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+        }};
+        for(unsigned int v = 0;v < vertex_count;v++)
+            vertex_score[v] = score(v);
+
+        std::size_t best {0};
+        for(std::size_t t = 1;t < triangle_count;t++)
+        {
+            if(triangle_score(t) > triangle_score(best))
+                best = t;
+        }
+
+        std::vector<bool> emitted(triangle_count,false);
+        std::vector<unsigned int> cache,next_cache;
+        cache.reserve(cache_size + 3);
+        next_cache.reserve(cache_size + 3);
+        std::size_t cursor {0};
+        for(std::size_t n = 0;n < triangle_count;n++)
+        {
+            if(best == none)
+            {
+                // nothing left around the cache, take the next triangle of the input
+                while(emitted[cursor])
+                    ++cursor;
+                best = cursor;
+            }
+
+            emitted[best] = true;
+            const std::array<unsigned int,3> corners {indices[best * 3],indices[best * 3 + 1],indices[best * 3 + 2]};
+            result.insert(result.end(),corners.begin(),corners.end());
+            for(const unsigned int v : corners)
+            {
+                std::uint32_t* triangles {adjacency.data() + offsets[v]};
+                const auto it {std::find(triangles,triangles + live[v],static_cast<std::uint32_t>(best))};
+                std::swap(*it,triangles[live[v] - 1]);
+                --live[v];
+            }
+
+            next_cache.clear();
+            for(const unsigned int v : corners)
+            {
+                if(std::find(next_cache.begin(),next_cache.end(),v) == next_cache.end())
+                    next_cache.push_back(v);
+            }
+            for(const unsigned int v : cache)
+            {
+                if(std::find(corners.begin(),corners.end(),v) == corners.end())
+                    next_cache.push_back(v);
+            }
+            for(std::size_t i = cache_size;i < next_cache.size();i++)
+            {
+                cache_position[next_cache[i]] = -1;
+                vertex_score[next_cache[i]] = score(next_cache[i]);
+            }
+            next_cache.resize(std::min(next_cache.size(),cache_size));
+            for(std::size_t i = 0;i < next_cache.size();i++)
+            {
+                cache_position[next_cache[i]] = static_cast<int>(i);
+                vertex_score[next_cache[i]] = score(next_cache[i]);
+            }
+            std::swap(cache,next_cache);
+
+            // the next triangle is the best one touching the cache
+            best = none;
+            float best_score {-1.0f};
+            for(const unsigned int v : cache)
+            {
+                for(std::uint32_t i = 0;i < live[v];i++)
+                {
+                    const std::uint32_t t {adjacency[offsets[v] + i]};
+                    const float value {triangle_score(t)};
+                    if(value > best_score)
+                    {
+                        best = t;
+                        best_score = value;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief optimize_vertex_cache() on a thread pool: the triangle list is cut into chunks of chunk_triangles
+     *        ordered on their own, the cache only misses a little more where chunks meet
+     * @note  chunks are cut along the vertex order, they stay compact when the vertices are
+     * @warning throw std::out_of_range when an index is not below vertex_count, before any chunk is submitted
+     *
+     * @param indices
+     * @param vertex_count
+     * @param pool
+     * @param chunk_triangles
+     * @param cache_size
+     * @return std::vector<unsigned int>
+     */
+    inline std::vector<unsigned int> optimize_vertex_cache(std::span<const unsigned int> indices,std::size_t vertex_count,ThreadPool& pool,
+        std::size_t chunk_triangles = 1 << 16,std::size_t cache_size = 32) noexcept(false)
+    {
+        const std::size_t triangle_count {indices.size() / 3};
+        chunk_triangles = std::max<std::size_t>(chunk_triangles,1);
+        if(triangle_count <= chunk_triangles)
+            return optimize_vertex_cache(indices,vertex_count,cache_size);
+
+        // bucket the triangles by their smallest vertex first, so a chunk keeps neighbours together
+        // even when the triangles come in no particular order
+        std::vector<std::uint32_t> starts(vertex_count + 1,0);
+        const auto smallest {[&](std::size_t t)
+        {
+            return std::min({indices[t * 3],indices[t * 3 + 1],indices[t * 3 + 2]});
+        }};
+        // every index is checked here, a task must not throw while the others still read sorted
+        for(std::size_t i = 0;i < triangle_count * 3;i++)
+        {
+            if(indices[i] >= vertex_count)
+                throw std::out_of_range("index out of vertex count");
+        }
+        for(std::size_t t = 0;t < triangle_count;t++)
+            ++starts[smallest(t) + 1];
+        std::inclusive_scan(starts.begin(),starts.end(),starts.begin());
+        std::vector<unsigned int> sorted(triangle_count * 3);
+        for(std::size_t t = 0;t < triangle_count;t++)
+            std::copy_n(indices.begin() + t * 3,3,sorted.begin() + std::size_t(starts[smallest(t)]++) * 3);
+
+        // the tasks read sorted, so every one of them is waited for before leaving, exceptions included
+        std::vector<std::future<std::vector<unsigned int>>> chunks;
+        chunks.reserve((triangle_count + chunk_triangles - 1) / chunk_triangles);
+        try
+        {
+            for(std::size_t begin = 0;begin < triangle_count;begin += chunk_triangles)
+            {
+                const std::span<const unsigned int> chunk {std::span<const unsigned int>(sorted).subspan(begin * 3,std::min(chunk_triangles,triangle_count - begin) * 3)};
+                chunks.push_back(pool.submit([chunk,cache_size]()
+                {
+                    // give the chunk its own compact vertex range so it does not pay for the whole mesh
+                    std::vector<unsigned int> vertices(chunk.begin(),chunk.end());
+                    std::sort(vertices.begin(),vertices.end());
+                    vertices.erase(std::unique(vertices.begin(),vertices.end()),vertices.end());
+
+                    std::vector<unsigned int> local(chunk.size());
+                    for(std::size_t i = 0;i < chunk.size();i++)
+                        local[i] = static_cast<unsigned int>(std::lower_bound(vertices.begin(),vertices.end(),chunk[i]) - vertices.begin());
+                    std::vector<unsigned int> ordered {optimize_vertex_cache(local,vertices.size(),cache_size)};
+                    for(auto& index : ordered)
+                        index = vertices[index];
+                    return ordered;
+                }));
+            }
+        }
+        catch(...)
+        {
+            wait_all(chunks);
+            throw;
+        }
+        wait_all(chunks);
+
+        std::vector<unsigned int> result;
+        result.reserve(triangle_count * 3);
+        for(auto& chunk : chunks)
+        {
+            const std::vector<unsigned int> ordered {chunk.get()};
+            result.insert(result.end(),ordered.begin(),ordered.end());
+        }
+        return result;
+    }
+
+    /**
+     * @brief reorder clusters of a cache-optimized triangle list so that outward facing ones come first,
+     *        hiding more of the mesh behind the early triangles when drawn with the depth test
+     * @note  clusters break where the cache is cold anyway, and where the cache cost stays within threshold
+     *        times the cost of the cluster. positions are 3 floats at position_offset in each vertex
+     * @warning throw std::out_of_range when the positions do not fit in vertex_len or an index is past the vertices
+     *
+     * @param indices           the output of optimize_vertex_cache()
+     * @param vertices          interleaved, as given to VertexBuffer
+     * @param vertex_len        by count
+     * @param position_offset   by count
+     * @param threshold         1 keeps the cache order, 1.05 allows 5% more vertex transforms
+     * @param cache_size
+     * @return std::vector<unsigned int>
+     */
+    inline std::vector<unsigned int> optimize_overdraw(std::span<const unsigned int> indices,std::span<const float> vertices,std::size_t vertex_len,
+        std::size_t position_offset = 0,float threshold = 1.05f,std::size_t cache_size = 16) noexcept(false)
+    {
+        if(vertex_len == 0 || position_offset + 3 > vertex_len)
+            throw std::out_of_range("position out of vertex length");
+        const std::size_t vertex_count {vertices.size() / vertex_len};
+        const std::size_t triangle_count {indices.size() / 3};
+        for(std::size_t i = 0;i < triangle_count * 3;i++)
+        {
+            if(indices[i] >= vertex_count)
+                throw std::out_of_range("index out of vertex count");
+        }
+
+        std::vector<std::size_t> loaded(vertex_count,0);
+        std::size_t time {cache_size + 1};
+        const auto misses {[&](std::size_t t)
+        {
+            std::size_t count {0};
+            for(std::size_t i = 0;i < 3;i++)
+            {
+                const unsigned int v {indices[t * 3 + i]};
+                if(time - loaded[v] > cache_size)
+                {
+                    loaded[v] = time++;
+                    ++count;
+                }
+            }
+            return count;
+        }};
+        const auto reset_cache {[&]()
+        {
+            time += cache_size + 1;
+        }};
+
+        // hard boundaries: triangles missing all of their vertices
+        std::vector<std::size_t> hard {0};
+        std::vector<std::size_t> hard_misses {0};
+        for(std::size_t t = 0;t < triangle_count;t++)
+        {
+            const std::size_t count {misses(t)};
+            if(count == 3 && t != 0)
+            {
+                hard.push_back(t);
+                hard_misses.push_back(0);
+            }
+            hard_misses.back() += count;
+        }
+        hard.push_back(triangle_count);
+
+        // soft boundaries: split a cluster once the part so far is cheap enough to start the cache cold again
+        std::vector<std::size_t> clusters;
+        for(std::size_t c = 0;c + 1 < hard.size();c++)
+        {
+            const float cluster_acmr {static_cast<float>(hard_misses[c]) / (hard[c + 1] - hard[c])};
+            reset_cache();
+            clusters.push_back(hard[c]);
+            std::size_t part_misses {0};
+            std::size_t part_triangles {0};
+            for(std::size_t t = hard[c];t < hard[c + 1];t++)
+            {
+                part_misses += misses(t);
+                ++part_triangles;
+                if(t + 1 < hard[c + 1] && static_cast<float>(part_misses) / part_triangles <= cluster_acmr * threshold)
+                {
+                    reset_cache();
+                    clusters.push_back(t + 1);
+                    part_misses = 0;
+                    part_triangles = 0;
+                }
+            }
+        }
+        clusters.push_back(triangle_count);
+
+        // area weighted centroid and normal of each cluster
+        const auto position {[&](unsigned int v)
+        {
+            const float* p {&vertices[v * vertex_len + position_offset]};
+            return std::array<float,3> {p[0],p[1],p[2]};
+        }};
+        const std::size_t cluster_count {clusters.size() - 1};
+        std::vector<std::array<float,3>> centroids(cluster_count,{0.0f,0.0f,0.0f});
+        std::vector<std::array<float,3>> normals(cluster_count,{0.0f,0.0f,0.0f});
+        std::array<float,3> mesh_centroid {0.0f,0.0f,0.0f};
+        float mesh_area {0.0f};
+        for(std::size_t c = 0;c < cluster_count;c++)
+        {
+            float cluster_area {0.0f};
+            for(std::size_t t = clusters[c];t < clusters[c + 1];t++)
+            {
+                const auto a {position(indices[t * 3])},b {position(indices[t * 3 + 1])},d {position(indices[t * 3 + 2])};
+                const std::array<float,3> u {b[0] - a[0],b[1] - a[1],b[2] - a[2]};
+                const std::array<float,3> w {d[0] - a[0],d[1] - a[1],d[2] - a[2]};
+                const std::array<float,3> cross {u[1] * w[2] - u[2] * w[1],u[2] * w[0] - u[0] * w[2],u[0] * w[1] - u[1] * w[0]};
+                const float area {std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2])};
+                for(std::size_t axis = 0;axis < 3;axis++)
+                {
+                    centroids[c][axis] += (a[axis] + b[axis] + d[axis]) / 3.0f * area;
+                    normals[c][axis] += cross[axis];
+                }
+                cluster_area += area;
+            }
+            for(std::size_t axis = 0;axis < 3;axis++)
+            {
+                mesh_centroid[axis] += centroids[c][axis];
+                centroids[c][axis] = cluster_area == 0.0f ? 0.0f : centroids[c][axis] / cluster_area;
+            }
+            mesh_area += cluster_area;
+        }
+        for(auto& axis : mesh_centroid)
+            axis = mesh_area == 0.0f ? 0.0f : axis / mesh_area;
+
+        std::vector<float> keys(cluster_count);
+        for(std::size_t c = 0;c < cluster_count;c++)
+        {
+            const auto& n {normals[c]};
+            const float len {std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2])};
+            float dot {0.0f};
+            for(std::size_t axis = 0;axis < 3;axis++)
+                dot += (centroids[c][axis] - mesh_centroid[axis]) * n[axis];
+            keys[c] = len == 0.0f ? 0.0f : dot / len;
+        }
+        std::vector<std::size_t> order(cluster_count);
+        std::iota(order.begin(),order.end(),std::size_t(0));
+        std::stable_sort(order.begin(),order.end(),[&](std::size_t a,std::size_t b){return keys[a] > keys[b];});
+
+        std::vector<unsigned int> result;
+        result.reserve(triangle_count * 3);
+        for(const std::size_t c : order)
+            result.insert(result.end(),indices.begin() + clusters[c] * 3,indices.begin() + clusters[c + 1] * 3);
+        return result;
+    }
+
+    constexpr unsigned int unused_vertex {std::numeric_limits<unsigned int>::max()};
+
+    /**
+     * @brief number the vertices in the order the indices first use them, unused vertices get unused_vertex
+     *
+     * @param indices
+     * @param vertex_count
+     * @return std::vector<unsigned int> the new position of each vertex
+     */
+    inline std::vector<unsigned int> vertex_fetch_remap(std::span<const unsigned int> indices,std::size_t vertex_count) noexcept(false)
+    {
+        std::vector<unsigned int> remap(vertex_count,unused_vertex);
+        unsigned int next {0};
+        for(const unsigned int index : indices)
+        {
+            if(index >= vertex_count)
+                throw std::out_of_range("index out of vertex count");
+            if(remap[index] == unused_vertex)
+                remap[index] = next++;
+        }
+        return remap;
+    }
+
+    /**
+     * @brief lay the vertices out in the order the indices fetch them, rewriting the indices to match.
+     *        unused vertices are dropped
+     *
+     * @param indices       rewritten
+     * @param vertices      interleaved, as given to VertexBuffer
+     * @param vertex_len    by count
+     * @return std::vector<float> the vertices in their new order
+     */
+    inline std::vector<float> optimize_vertex_fetch(std::span<unsigned int> indices,std::span<const float> vertices,std::size_t vertex_len) noexcept(false)
+    {
+        if(vertex_len == 0)
+            throw std::out_of_range("vertex length is 0");
+        const std::vector<unsigned int> remap {vertex_fetch_remap(indices,vertices.size() / vertex_len)};
+        const std::size_t used {static_cast<std::size_t>(std::count_if(remap.begin(),remap.end(),[](unsigned int v){return v != unused_vertex;}))};
+
+        std::vector<float> result(used * vertex_len);
+        for(std::size_t v = 0;v < remap.size();v++)
+        {
+            if(remap[v] != unused_vertex)
+                std::copy_n(vertices.begin() + v * vertex_len,vertex_len,result.begin() + std::size_t(remap[v]) * vertex_len);
+        }
+        for(auto& index : indices)
+            index = remap[index];
+        return result;
+    }
+
+    struct MeshOptimizeOptions
+    {
+        std::size_t position_offset {0};            // by count, 3 floats
+        std::size_t cache_size {32};                // of the Forsyth scoring
+        std::size_t analysis_cache_size {16};       // of the FIFO the report is measured with
+        float overdraw_threshold {1.05f};           // 0 skips the overdraw pass
+        std::size_t chunk_triangles {1 << 16};      // meshes with more triangles are ordered by chunks on the pool
+    };
+
+    struct MeshOptimizeReport
+    {
+        VertexCacheStats before;
+        VertexCacheStats after;
+    };
+
+    /**
+     * @brief run the whole pipeline over the data of a VertexBuffer and an ElementBuffer:
+     *        vertex cache order, overdraw cluster order, then vertex fetch order
+     * @warning throw std::runtime_error when indices is not a triangle list,
+     *          std::out_of_range when an index is past the vertices or the position does not fit in vertex_len
+     *
+     * @param vertices      interleaved floats, rewritten
+     * @param vertex_len    by count
+     * @param indices       a triangle list, rewritten
+     * @param options
+     * @param pool          used for meshes above options.chunk_triangles, default_thread_pool() if null
+     * @return MeshOptimizeReport ACMR and ATVR before and after
+     */
+    inline MeshOptimizeReport optimize_mesh(std::vector<float>& vertices,std::size_t vertex_len,std::vector<unsigned int>& indices,
+        const MeshOptimizeOptions& options = {},ThreadPool* pool = nullptr) noexcept(false)
+    {
+        if(indices.size() % 3 != 0)
+            throw std::runtime_error("index count is not a multiple of 3");
+        if(vertex_len == 0 || options.position_offset + 3 > vertex_len)
+            throw std::out_of_range("position out of vertex length");
+
+        MeshOptimizeReport report;
+        const std::size_t vertex_count {vertices.size() / vertex_len};
+        report.before = analyze_vertex_cache(indices,vertex_count,options.analysis_cache_size);
+
+        if(indices.size() / 3 > options.chunk_triangles)
+            indices = optimize_vertex_cache(indices,vertex_count,pool != nullptr ? *pool : default_thread_pool(),options.chunk_triangles,options.cache_size);
+        else
+            indices = optimize_vertex_cache(indices,vertex_count,options.cache_size);
+        if(options.overdraw_threshold > 0.0f)
+            indices = optimize_overdraw(indices,vertices,vertex_len,options.position_offset,options.overdraw_threshold,options.analysis_cache_size);
+        vertices = optimize_vertex_fetch(indices,vertices,vertex_len);
+
+        report.after = analyze_vertex_cache(indices,vertices.size() / vertex_len,options.analysis_cache_size);
+        return report;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "layout.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace graphics
+{
+    enum class NormalEncoding
+    {
+        Octahedral,     // two unorm16, decoded in the shader with octahedral_decode_glsl
+        Int2101010      // GL_INT_2_10_10_10_REV, arrives as a normalized vec4
+    };
+
+    /**
+     * @brief GLSL function turning an octahedral normal attribute back into a unit vector
+     *
+     */
+    constexpr std::string_view octahedral_decode_glsl
+    {
+        "vec3 decode_octahedral(vec2 e)\n"
+        "{\n"
+        "    e = e * 2.0 - 1.0;\n"
+        "    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));\n"
+        "    if(n.z < 0.0)\n"
+        "        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);\n"
+        "    return normalize(n);\n"
+        "}\n"
+    };
+
+    /**
+     * @brief 18 bytes (octahedral) or 20 bytes (Int2101010) per vertex, against 48 bytes of floats
+     * @note  attribute locations: 0 position, 1 color, 2 uv, 3 normal. the position is relative to the
+     *        bounds of its mesh, decode it with PackedMesh::position_offset and position_scale
+     *
+     * @tparam encoding
+     */
+    template <NormalEncoding encoding = NormalEncoding::Octahedral>
+    struct PackedVertex
+    {
+        using Normal = std::conditional_t<encoding == NormalEncoding::Octahedral,std::array<std::uint16_t,2>,Int2101010>;
+
+        std::array<std::uint16_t,3> position;
+        std::array<std::uint8_t,4> color;
+        std::array<Half,2> uv;
+        Normal normal;
+
+        using Layout = VertexLayout<
+            Attrib<0,&PackedVertex::position,AttribMode::Normalized>,
+            Attrib<1,&PackedVertex::color,AttribMode::Normalized>,
+            Attrib<2,&PackedVertex::uv>,
+            Attrib<3,&PackedVertex::normal,AttribMode::Normalized>>;
+    };
+
+    /**
+     * @brief where the attributes are in an interleaved float vertex, by count
+     *
+     */
+    struct PackSource
+    {
+        std::span<const float> vertices;
+        std::size_t vertex_len;
+        std::size_t position_offset {0};            // 3 floats
+        std::optional<std::size_t> color_offset;    // 4 floats, white if absent
+        std::optional<std::size_t> uv_offset;       // 2 floats, zero if absent
+        std::optional<std::size_t> normal_offset;   // 3 floats, +z if absent
+    };
+
+    /**
+     * @brief the largest error packing made over a mesh
+     *
+     */
+    struct PackError
+    {
+        float position {0.0f};      // in mesh units, per axis
+        float color {0.0f};
+        float uv {0.0f};
+        float normal {0.0f};        // angle, in radians
+    };
+
+    template <NormalEncoding encoding = NormalEncoding::Octahedral>
+    struct PackedMesh
+    {
+        std::vector<PackedVertex<encoding>> vertices;
+        std::array<float,3> position_offset {};     // position = position_offset + position_scale * attribute
+        std::array<float,3> position_scale {};
+        PackError error;
+    };
+
+    inline std::uint16_t encode_unorm16(float value) noexcept
+    {
+        return static_cast<std::uint16_t>(std::lround(std::clamp(value,0.0f,1.0f) * 65535.0f));
+    }
+
+    inline std::uint8_t encode_unorm8(float value) noexcept
+    {
+        return static_cast<std::uint8_t>(std::lround(std::clamp(value,0.0f,1.0f) * 255.0f));
+    }
+
+    /**
+     * @brief map a direction onto the octahedron, then to [0,1]^2
+     *
+     * @param normal does not need to be normalized
+     * @return std::array<float,2>
+     */
+    inline std::array<float,2> encode_octahedral(const std::array<float,3>& normal) noexcept
+    {
+        const float l1 {std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2])};
+        if(l1 == 0.0f)
+            return {0.5f,0.5f};
+
+        float x {normal[0] / l1};
+        float y {normal[1] / l1};
+        if(normal[2] < 0.0f)
+        {
+            const float folded_x {(1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f)};
+            const float folded_y {(1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f)};
+            x = folded_x;
+            y = folded_y;
+        }
+        return {x * 0.5f + 0.5f,y * 0.5f + 0.5f};
+    }
+
+    /**
+     * @brief the CPU twin of octahedral_decode_glsl
+     *
+     * @param encoded
+     * @return std::array<float,3> a unit vector
+     */
+    inline std::array<float,3> decode_octahedral(const std::array<float,2>& encoded) noexcept
+    {
+        float x {encoded[0] * 2.0f - 1.0f};
+        float y {encoded[1] * 2.0f - 1.0f};
+        const float z {1.0f - std::abs(x) - std::abs(y)};
+        if(z < 0.0f)
+        {
+            const float unfolded_x {(1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f)};
+            const float unfolded_y {(1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f)};
+            x = unfolded_x;
+            y = unfolded_y;
+        }
+        const float len {std::sqrt(x * x + y * y + z * z)};
+        return {x / len,y / len,z / len};
+    }
+
+    /**
+     * @brief pack a direction as three snorm10 components, w is 0
+     *
+     * @param normal
+     * @return Int2101010
+     */
+    inline Int2101010 encode_int2101010(const std::array<float,3>& normal) noexcept
+    {
+        const float len {std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2])};
+        std::uint32_t bits {0};
+        for(std::size_t i = 0;i < 3;i++)
+        {
+            const float value {len == 0.0f ? (i == 2 ? 1.0f : 0.0f) : normal[i] / len};
+            const auto c {static_cast<std::int32_t>(std::lround(std::clamp(value,-1.0f,1.0f) * 511.0f))};
+            bits |= (static_cast<std::uint32_t>(c) & 0x3FF) << (i * 10);
+        }
+        return Int2101010 {bits};
+    }
+
+    /**
+     * @brief unpack the xyz of an Int2101010 as OpenGL would
+     *
+     * @param packed
+     * @param legacy    use the (2c + 1) / 1023 rule of OpenGL before 4.2 instead of max(c / 511,-1)
+     * @return std::array<float,3>
+     */
+    inline std::array<float,3> decode_int2101010(Int2101010 packed,bool legacy = false) noexcept
+    {
+        std::array<float,3> value;
+        for(std::size_t i = 0;i < 3;i++)
+        {
+            std::int32_t c {static_cast<std::int32_t>((packed.bits >> (i * 10)) & 0x3FF)};
+            if(c >= 512)
+                c -= 1024;
+            value[i] = legacy ? (2.0f * c + 1.0f) / 1023.0f : std::max(c / 511.0f,-1.0f);
+        }
+        return value;
+    }
+
+    /**
+     * @brief angle between two directions, in radians
+     *
+     */
+    inline float angle_between(const std::array<float,3>& a,const std::array<float,3>& b) noexcept
+    {
+        const float dot {a[0] * b[0] + a[1] * b[1] + a[2] * b[2]};
+        const float len {std::sqrt((a[0] * a[0] + a[1] * a[1] + a[2] * a[2]) * (b[0] * b[0] + b[1] * b[1] + b[2] * b[2]))};
+        if(len == 0.0f)
+            return 0.0f;
+        return std::acos(std::clamp(dot / len,-1.0f,1.0f));
+    }
+
+    /**
+     * @brief quantize an interleaved float mesh into PackedVertex, measuring the error on the way
+     * @warning throw std::runtime_error when an attribute does not fit in vertex_len
+     *
+     * @tparam encoding
+     * @param source
+     * @return PackedMesh<encoding>
+     */
+    template <NormalEncoding encoding = NormalEncoding::Octahedral>
+    PackedMesh<encoding> pack_mesh(const PackSource& source) noexcept(false)
+    {
+        const auto fits {[&](std::optional<std::size_t> offset,std::size_t len)
+        {
+            return !offset || *offset + len <= source.vertex_len;
+        }};
+        if(source.vertex_len == 0 || !fits(source.position_offset,3) || !fits(source.color_offset,4) || !fits(source.uv_offset,2) || !fits(source.normal_offset,3))
+            throw std::runtime_error("vertex attribute out of vertex lenth");
+
+        const std::size_t vertex_count {source.vertices.size() / source.vertex_len};
+        const auto read {[&](std::size_t vertex,std::size_t offset)
+        {
+            return &source.vertices[vertex * source.vertex_len + offset];
+        }};
+
+        PackedMesh<encoding> mesh;
+        mesh.vertices.resize(vertex_count);
+        if(vertex_count == 0)
+            return mesh;
+
+        // bounds of the positions
+        std::array<float,3> max_position;
+        for(std::size_t axis = 0;axis < 3;axis++)
+            mesh.position_offset[axis] = max_position[axis] = read(0,source.position_offset)[axis];
+        for(std::size_t i = 1;i < vertex_count;i++)
+        {
+            for(std::size_t axis = 0;axis < 3;axis++)
+            {
+                mesh.position_offset[axis] = std::min(mesh.position_offset[axis],read(i,source.position_offset)[axis]);
+                max_position[axis] = std::max(max_position[axis],read(i,source.position_offset)[axis]);
+            }
+        }
+        for(std::size_t axis = 0;axis < 3;axis++)
+            mesh.position_scale[axis] = max_position[axis] - mesh.position_offset[axis];
+
+        PackError& error {mesh.error};
+        for(std::size_t i = 0;i < vertex_count;i++)
+        {
+            PackedVertex<encoding>& vertex {mesh.vertices[i]};
+
+            const float* position {read(i,source.position_offset)};
+            for(std::size_t axis = 0;axis < 3;axis++)
+            {
+                const float scale {mesh.position_scale[axis]};
+                vertex.position[axis] = scale == 0.0f ? 0 : encode_unorm16((position[axis] - mesh.position_offset[axis]) / scale);
+                const float decoded {mesh.position_offset[axis] + scale * (vertex.position[axis] / 65535.0f)};
+                error.position = std::max(error.position,std::abs(decoded - position[axis]));
+            }
+
+            if(source.color_offset)
+            {
+                const float* color {read(i,*source.color_offset)};
+                for(std::size_t c = 0;c < 4;c++)
+                {
+                    vertex.color[c] = encode_unorm8(color[c]);
+                    error.color = std::max(error.color,std::abs(vertex.color[c] / 255.0f - color[c]));
+                }
+            }
+            else
+                vertex.color = {255,255,255,255};
+
+            if(source.uv_offset)
+            {
+                const float* uv {read(i,*source.uv_offset)};
+                for(std::size_t c = 0;c < 2;c++)
+                {
+                    vertex.uv[c] = Half(uv[c]);
+                    error.uv = std::max(error.uv,std::abs(static_cast<float>(vertex.uv[c]) - uv[c]));
+                }
+            }
+
+            std::array<float,3> normal {0.0f,0.0f,1.0f};
+            if(source.normal_offset)
+            {
+                const float* n {read(i,*source.normal_offset)};
+                normal = {n[0],n[1],n[2]};
+            }
+            if constexpr(encoding == NormalEncoding::Octahedral)
+            {
+                const std::array<float,2> encoded {encode_octahedral(normal)};
+                vertex.normal = {encode_unorm16(encoded[0]),encode_unorm16(encoded[1])};
+                const std::array<float,3> decoded {decode_octahedral({vertex.normal[0] / 65535.0f,vertex.normal[1] / 65535.0f})};
+                error.normal = std::max(error.normal,angle_between(normal,decoded));
+            }
+            else
+            {
+                // drivers differ in which snorm rule they use before OpenGL 4.2, bound both
+                vertex.normal = encode_int2101010(normal);
+                error.normal = std::max({error.normal,angle_between(normal,decode_int2101010(vertex.normal)),
+                    angle_between(normal,decode_int2101010(vertex.normal,true))});
+            }
+        }
+        return mesh;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "context.hpp"
+#include "scope.hpp"
+#include <glad/glad.h>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+
+namespace graphics
+{
+    /**
+     * @brief depth and stencil status of a DepthStencilState, the defaults are the OpenGL ones
+     *
+     */
+    struct DepthStencilDesc
+    {
+        bool depth_test {false};
+        bool depth_write {true};
+        TestFuncType depth_func {TestFuncType::Less};
+        bool stencil_test {false};
+        TestFuncType stencil_func {TestFuncType::Always};
+        int stencil_ref {0};
+        unsigned int stencil_value_mask {0xffffffff};
+        unsigned int stencil_write_mask {0xffffffff};
+        StencilOpType stencil_fail_op {StencilOpType::Keep};
+        StencilOpType stencil_depth_fail_op {StencilOpType::Keep};
+        StencilOpType stencil_pass_op {StencilOpType::Keep};
+
+        static constexpr FieldMask fields {field_bits<Field::DepthTest,Field::DepthFunc,Field::DepthMask,
+            Field::StencilTest,Field::StencilFunc,Field::StencilMask,Field::StencilOp>()};
+
+        bool operator==(const DepthStencilDesc&) const = default;
+
+        auto tie() const noexcept
+        {
+            return std::tie(depth_test,depth_write,depth_func,stencil_test,stencil_func,stencil_ref,
+                stencil_value_mask,stencil_write_mask,stencil_fail_op,stencil_depth_fail_op,stencil_pass_op);
+        }
+
+        void apply(StatusCache& cache) const noexcept
+        {
+            cache.set_depth_test(depth_test);
+            cache.set_depth_mask(depth_write);
+            cache.set_depth_func(static_cast<GLint>(depth_func));
+            cache.set_stencil_test(stencil_test);
+            cache.set_stencil_func(static_cast<GLint>(stencil_func),stencil_ref,stencil_value_mask);
+            cache.set_stencil_mask(stencil_write_mask);
+            cache.set_stencil_op(static_cast<GLint>(stencil_fail_op),static_cast<GLint>(stencil_depth_fail_op),static_cast<GLint>(stencil_pass_op));
+        }
+    };
+
+    /**
+     * @brief blend status of a BlendState, the defaults are the OpenGL ones
+     *
+     */
+    struct BlendDesc
+    {
+        bool blend {false};
+        BlendFuncType src_rgb {BlendFuncType::One};
+        BlendFuncType dst_rgb {BlendFuncType::Zero};
+        BlendFuncType src_alpha {BlendFuncType::One};
+        BlendFuncType dst_alpha {BlendFuncType::Zero};
+        float color_r {0.0f};
+        float color_g {0.0f};
+        float color_b {0.0f};
+        float color_a {0.0f};
+
+        static constexpr FieldMask fields {field_bits<Field::BlendTest,Field::BlendFunc,Field::BlendColor>()};
+
+        bool operator==(const BlendDesc&) const = default;
+
+        auto tie() const noexcept
+        {
+            return std::tie(blend,src_rgb,dst_rgb,src_alpha,dst_alpha,color_r,color_g,color_b,color_a);
+        }
+
+        void apply(StatusCache& cache) const noexcept
+        {
+            cache.set_blend(blend);
+            cache.set_blend_func(static_cast<GLint>(src_rgb),static_cast<GLint>(dst_rgb),static_cast<GLint>(src_alpha),static_cast<GLint>(dst_alpha));
+            cache.set_blend_color(color_r,color_g,color_b,color_a);
+        }
+    };
+
+    /**
+     * @brief rasterizer status of a RasterState, the defaults are the OpenGL ones
+     *
+     */
+    struct RasterDesc
+    {
+        bool cull_face {false};
+        CullFaceType cull_face_type {CullFaceType::Back};
+        CullFrontFaceType front_face_type {CullFrontFaceType::CCW};
+        PolygonModes polygon_mode {PolygonModes::Fill};
+        float line_width {1.0f};
+
+        static constexpr FieldMask fields {field_bits<Field::CullFaceTest,Field::CullFace,Field::FrontFace,Field::PolygonMode,Field::LineWidth>()};
+
+        bool operator==(const RasterDesc&) const = default;
+
+        auto tie() const noexcept
+        {
+            return std::tie(cull_face,cull_face_type,front_face_type,polygon_mode,line_width);
+        }
+
+        void apply(StatusCache& cache) const noexcept
+        {
+            cache.set_cull_face_test(cull_face);
+            cache.set_cull_face(static_cast<GLint>(cull_face_type));
+            cache.set_front_face(static_cast<GLint>(front_face_type));
+            cache.set_polygon_mode(GL_FRONT_AND_BACK,static_cast<GLint>(polygon_mode));
+            cache.set_line_width(line_width);
+        }
+    };
+
+    /**
+     * @brief an immutable and interned group of OpenGL status
+     * @note  equal descriptions share one interned copy, so comparing two states is a pointer compare
+     *
+     * @tparam Desc DepthStencilDesc, BlendDesc or RasterDesc
+     */
+    template <typename Desc>
+    class PipelineState
+    {
+    private:
+        const Desc* desc;
+
+        struct DescHash
+        {
+            std::size_t operator()(const Desc& desc) const noexcept
+            {
+                return std::apply([](const auto&... members)
+                {
+                    std::size_t seed {0};
+                    ((seed ^= std::hash<std::decay_t<decltype(members)>>{}(members) + 0x9e3779b9 + (seed << 6) + (seed >> 2)),...);
+                    return seed;
+                },desc.tie());
+            }
+        };
+
+        /**
+         * @brief find the interned copy of desc, create it if this is the first time
+         * @note  interned descriptions live until the program exits, their addresses never change
+         *
+         * @param desc
+         * @return const Desc*
+         */
+        static const Desc* intern(const Desc& desc) noexcept(false)
+        {
+            static std::mutex mutex;
+            static std::unordered_set<Desc,DescHash> interned;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            return &*interned.insert(desc).first;
+        }
+
+    public:
+        explicit PipelineState(const Desc& desc) noexcept(false)
+            : desc {intern(desc)}
+        {
+        }
+
+        const Desc& get_desc() const noexcept
+        {
+            return *desc;
+        }
+
+        bool operator==(const PipelineState&) const = default;
+
+        /**
+         * @brief make OpenGL use this status, only the calls that differ from the current status are issued
+         * @note  applying the state that is already applied costs a few pointer compares
+         * @warning this will change the status of OpenGL
+         *
+         */
+        void apply() const noexcept
+        {
+            StatusCache& cache {status_cache()};
+            if(cache.is_applied(desc,Desc::fields))
+                return;
+            desc->apply(cache);
+            cache.mark_applied(desc,Desc::fields);
+        }
+    };
+
+    using DepthStencilState = PipelineState<DepthStencilDesc>;
+    using BlendState = PipelineState<BlendDesc>;
+    using RasterState = PipelineState<RasterDesc>;
+}
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "vertex.hpp"
+#include <algorithm>
 #include <exception>
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 namespace graphics
 {
@@ -13,11 +17,10 @@ namespace graphics
     };
 
     template <typename T>
-    concept VertexArrayServiceWithEBO= requires(T t)
+    concept VertexArrayServiceWithEBO= VertexArrayService<T> && requires(T t)
     {
-        {t.get_vao_id()} -> std::same_as<unsigned int>;
-        {t.get_binding_vbo_id()} -> std::same_as<unsigned int>;
         {t.get_binding_ebo_id()} -> std::same_as<unsigned int>;
+        {t.get_index_type()} -> std::same_as<GLenum>;
     };
 
     enum class Primitives
@@ -35,23 +38,57 @@ namespace graphics
         TriangleStripAdjacency  = GL_TRIANGLE_STRIP_ADJACENCY
     };
 
+    /**
+     * @brief the groups a draw changes for itself and puts back before returning, so drawing leaves the status as it found it
+     * @note  to draw a vertex array many times, bind() it inside a Scope first: the draws find it bound and change nothing
+     *
+     */
+    inline constexpr State draw_states {State::VertexArray | State::ArrayBuffer | State::Restart};
+
+    /**
+     * @brief bind what an indexed draw of vao reads, and turn primitive restart on when its ebo has a restart index
+     * @note  the restart index is the largest value of the index type, see ElementBuffer. an ebo without one leaves
+     *        primitive restart as the caller set it with enable_primitive_restart()
+     *
+     * @tparam VAO
+     * @param cache
+     * @param vao
+     */
+    template <VertexArrayServiceWithEBO VAO>
+    inline void bind_elements(StatusCache& cache,const VAO& vao) noexcept
+    {
+        cache.bind_vertex_array(vao.get_vao_id());
+        cache.bind_buffer(GL_ARRAY_BUFFER,vao.get_binding_vbo_id());
+        cache.bind_buffer(GL_ELEMENT_ARRAY_BUFFER,vao.get_binding_ebo_id());
+        if constexpr(requires {{vao.has_primitive_restart()} -> std::same_as<bool>;})
+        {
+            if(vao.has_primitive_restart())
+            {
+                cache.set_primitive_restart(true);
+                cache.set_primitive_restart_index(restart_index_of(vao.get_index_type()));
+            }
+        }
+    }
+
     /**
      * @brief draw the specified primitive from some points in the vertex array
      * 
      * @tparam primitive 
      * @tparam VAO 
+     * @note  leaves the status as it found it, see draw_states
      * @param vao 
      * @param vertex_count 
      */
     template <Primitives primitive,VertexArrayService VAO>
     inline void draw(const VAO& vao,std::size_t first,std::size_t vertex_count) noexcept
     {
-        Scope([&]()
-        {
-            glBindVertexArray(vao.get_vao_id());
-            glBindBuffer(GL_ARRAY_BUFFER,vao.get_binding_vbo_id());
-            glDrawArrays(static_cast<int>(primitive),first,vertex_count);
-        });
+        Context& context {Context::get_current()};
+        context.set_operation("draw",vao.get_vao_id());
+        StatusCache& cache {context.get_status_cache()};
+        const StatusRestorer<draw_states> restorer;
+        cache.bind_vertex_array(vao.get_vao_id());
+        cache.bind_buffer(GL_ARRAY_BUFFER,vao.get_binding_vbo_id());
+        glDrawArrays(static_cast<int>(primitive),first,vertex_count);
     }
 
     /**
@@ -59,18 +96,258 @@ namespace graphics
      * 
      * @tparam primitive 
      * @tparam VAO 
+     * @note  leaves the status as it found it, see draw_states
      * @param vao 
      * @param vertex_count 
      */
     template <Primitives primitive,VertexArrayServiceWithEBO VAO>
     inline void draw(const VAO& vao,std::size_t vertex_count) noexcept
     {
-        Scope([&]()
+        Context& context {Context::get_current()};
+        context.set_operation("draw",vao.get_vao_id());
+        StatusCache& cache {context.get_status_cache()};
+        const StatusRestorer<draw_states> restorer;
+        bind_elements(cache,vao);
+        glDrawElements(static_cast<int>(primitive),vertex_count,vao.get_index_type(),0);
+    }
+
+    /**
+     * @brief draw the specified primitive from some points in the vertex array, instance_count times in one call
+     * 
+     * @tparam primitive 
+     * @tparam VAO 
+     * @note  leaves the status as it found it, see draw_states
+     * @param vao 
+     * @param first 
+     * @param vertex_count 
+     * @param instance_count 
+     */
+    template <Primitives primitive,VertexArrayService VAO>
+    inline void draw_instanced(const VAO& vao,std::size_t first,std::size_t vertex_count,std::size_t instance_count) noexcept
+    {
+        Context& context {Context::get_current()};
+        context.set_operation("draw_instanced",vao.get_vao_id());
+        StatusCache& cache {context.get_status_cache()};
+        const StatusRestorer<draw_states> restorer;
+        cache.bind_vertex_array(vao.get_vao_id());
+        cache.bind_buffer(GL_ARRAY_BUFFER,vao.get_binding_vbo_id());
+        glDrawArraysInstanced(static_cast<int>(primitive),first,vertex_count,instance_count);
+    }
+
+    /**
+     * @brief draw the specified primitive from the indices of the vertex array, instance_count times in one call
+     * 
+     * @tparam primitive 
+     * @tparam VAO 
+     * @note  leaves the status as it found it, see draw_states
+     * @param vao 
+     * @param vertex_count 
+     * @param instance_count 
+     */
+    template <Primitives primitive,VertexArrayServiceWithEBO VAO>
+    inline void draw_instanced(const VAO& vao,std::size_t vertex_count,std::size_t instance_count) noexcept
+    {
+        Context& context {Context::get_current()};
+        context.set_operation("draw_instanced",vao.get_vao_id());
+        StatusCache& cache {context.get_status_cache()};
+        const StatusRestorer<draw_states> restorer;
+        bind_elements(cache,vao);
+        glDrawElementsInstanced(static_cast<int>(primitive),vertex_count,vao.get_index_type(),0,instance_count);
+    }
+
+    /**
+     * @brief draws of one vertex array collected to be submitted in one call
+     * @note  for a vao with an ebo, first is the first index of each draw and base_vertex is added to its indices,
+     *        otherwise first is the first vertex and base_vertex is ignored.
+     *        the byte offsets glMultiDrawElements takes are computed in add(), for the index type of the batch
+     *
+     */
+    class DrawBatch
+    {
+    private:
+        GLenum index_type;
+        std::vector<GLint> firsts;
+        std::vector<GLsizei> counts;
+        std::vector<GLint> base_vertices;
+        std::vector<const void*> offsets;
+
+        const void* offset_of(GLint first) const noexcept
+        {
+            return reinterpret_cast<const void*>(static_cast<std::size_t>(first) * index_size(index_type));
+        }
+
+    public:
+        /**
+         * @brief Construct a new Draw Batch object
+         *
+         * @param index_type    the index type of the ebo the batch is drawn from, if any
+         */
+        explicit DrawBatch(GLenum index_type = GL_UNSIGNED_INT) noexcept
+            : index_type(index_type)
+        {
+        }
+
+        void add(std::size_t first,std::size_t count,int base_vertex = 0) noexcept(false)
+        {
+            firsts.push_back(static_cast<GLint>(first));
+            counts.push_back(static_cast<GLsizei>(count));
+            base_vertices.push_back(base_vertex);
+            offsets.push_back(offset_of(firsts.back()));
+        }
+
+        void clear() noexcept
+        {
+            firsts.clear();
+            counts.clear();
+            base_vertices.clear();
+            offsets.clear();
+        }
+
+        /**
+         * @brief change the index type of the batch, the offsets of the draws already added are computed again
+         *
+         * @param new_index_type
+         */
+        void set_index_type(GLenum new_index_type) noexcept
+        {
+            if(new_index_type == index_type)
+                return;
+            index_type = new_index_type;
+            for(std::size_t i = 0;i < firsts.size();i++)
+                offsets[i] = offset_of(firsts[i]);
+        }
+
+        GLenum get_index_type() const noexcept
+        {
+            return index_type;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return counts.size();
+        }
+
+        std::span<const GLint> get_firsts() const noexcept
+        {
+            return firsts;
+        }
+
+        std::span<const GLsizei> get_counts() const noexcept
+        {
+            return counts;
+        }
+
+        std::span<const GLint> get_base_vertices() const noexcept
         {
-            glBindVertexArray(vao.get_vao_id());
-            glBindBuffer(GL_ARRAY_BUFFER,vao.get_binding_vbo_id());
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,vao.get_binding_ebo_id());
-            glDrawElements(static_cast<int>(primitive),vertex_count,GL_UNSIGNED_INT,0);
-        });
+            return base_vertices;
+        }
+
+        /**
+         * @brief Get the first indices as the byte offsets glMultiDrawElements takes
+         *
+         * @return std::span<const void* const>
+         */
+        std::span<const void* const> get_offsets() const noexcept
+        {
+            return offsets;
+        }
+    };
+
+    /**
+     * @brief draw many ranges of vertices of the vertex array in one call, glMultiDrawArrays
+     * 
+     * @tparam primitive 
+     * @tparam VAO 
+     * @note  leaves the status as it found it, see draw_states
+     * @param vao 
+     * @param firsts    the first vertex of each draw
+     * @param counts    the vertex count of each draw, as many as firsts
+     */
+    template <Primitives primitive,VertexArrayService VAO>
+    inline void multi_draw(const VAO& vao,std::span<const GLint> firsts,std::span<const GLsizei> counts) noexcept
+    {
+        Context& context {Context::get_current()};
+        context.set_operation("multi_draw",vao.get_vao_id());
+        StatusCache& cache {context.get_status_cache()};
+        const StatusRestorer<draw_states> restorer;
+        cache.bind_vertex_array(vao.get_vao_id());
+        cache.bind_buffer(GL_ARRAY_BUFFER,vao.get_binding_vbo_id());
+        glMultiDrawArrays(static_cast<int>(primitive),firsts.data(),counts.data(),static_cast<GLsizei>(std::min(firsts.size(),counts.size())));
+    }
+
+    /**
+     * @brief draw many ranges of indices of the vertex array in one call, glMultiDrawElements
+     * 
+     * @tparam primitive 
+     * @tparam VAO 
+     * @note  leaves the status as it found it, see draw_states
+     * @param vao 
+     * @param counts    the index count of each draw
+     * @param offsets   the byte offset of the first index of each draw, as many as counts
+     */
+    template <Primitives primitive,VertexArrayServiceWithEBO VAO>
+    inline void multi_draw(const VAO& vao,std::span<const GLsizei> counts,std::span<const void* const> offsets) noexcept
+    {
+        Context& context {Context::get_current()};
+        context.set_operation("multi_draw",vao.get_vao_id());
+        StatusCache& cache {context.get_status_cache()};
+        const StatusRestorer<draw_states> restorer;
+        bind_elements(cache,vao);
+        glMultiDrawElements(static_cast<int>(primitive),counts.data(),vao.get_index_type(),offsets.data(),static_cast<GLsizei>(std::min(counts.size(),offsets.size())));
+    }
+
+    /**
+     * @brief draw many ranges of indices of the vertex array in one call, each with its own base vertex,
+     *        glMultiDrawElementsBaseVertex
+     * 
+     * @tparam primitive 
+     * @tparam VAO 
+     * @note  leaves the status as it found it, see draw_states
+     * @param vao 
+     * @param counts        the index count of each draw
+     * @param offsets       the byte offset of the first index of each draw, as many as counts
+     * @param base_vertices added to the indices of each draw, as many as counts
+     */
+    template <Primitives primitive,VertexArrayServiceWithEBO VAO>
+    inline void multi_draw(const VAO& vao,std::span<const GLsizei> counts,std::span<const void* const> offsets,std::span<const GLint> base_vertices) noexcept
+    {
+        Context& context {Context::get_current()};
+        context.set_operation("multi_draw",vao.get_vao_id());
+        StatusCache& cache {context.get_status_cache()};
+        const StatusRestorer<draw_states> restorer;
+        bind_elements(cache,vao);
+        glMultiDrawElementsBaseVertex(static_cast<int>(primitive),counts.data(),vao.get_index_type(),offsets.data(),
+            static_cast<GLsizei>(std::min({counts.size(),offsets.size(),base_vertices.size()})),base_vertices.data());
+    }
+
+    /**
+     * @brief submit a batch of vertex ranges in one call
+     * 
+     * @tparam primitive 
+     * @tparam VAO 
+     * @param vao 
+     * @param batch 
+     */
+    template <Primitives primitive,VertexArrayService VAO>
+    inline void multi_draw(const VAO& vao,const DrawBatch& batch) noexcept
+    {
+        multi_draw<primitive>(vao,batch.get_firsts(),batch.get_counts());
+    }
+
+    /**
+     * @brief submit a batch of index ranges in one call, with their base vertices
+     * @warning throw std::invalid_argument when the batch was built for another index type than the one of vao
+     * 
+     * @tparam primitive 
+     * @tparam VAO 
+     * @param vao 
+     * @param batch 
+     */
+    template <Primitives primitive,VertexArrayServiceWithEBO VAO>
+    inline void multi_draw(const VAO& vao,const DrawBatch& batch) noexcept(false)
+    {
+        if(batch.get_index_type() != vao.get_index_type())
+            throw std::invalid_argument("DrawBatch index type differs from the vertex array");
+        multi_draw<primitive>(vao,batch.get_counts(),batch.get_offsets(),batch.get_base_vertices());
     }
 }
\ No newline at end of file
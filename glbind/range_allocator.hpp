@@ -0,0 +1,279 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace graphics
+{
+    /**
+     * @brief two-level segregated fit (TLSF) allocator of ranges in [0,capacity), it never touches the memory itself
+     * @note  allocate() and free() run in constant time, free neighbours are merged right away.
+     *        sizes and offsets have no unit, use them as vertices or indices
+     *
+     */
+    class RangeAllocator
+    {
+    public:
+        static constexpr std::uint32_t invalid_node {std::numeric_limits<std::uint32_t>::max()};
+
+        /**
+         * @brief a range handed out by allocate(), node is invalid_node if it failed
+         *
+         */
+        struct Allocation
+        {
+            std::size_t offset {0};
+            std::size_t size {0};
+            std::uint32_t node {invalid_node};
+
+            bool is_valid() const noexcept
+            {
+                return node != invalid_node;
+            }
+        };
+
+    private:
+        static constexpr unsigned int sl_bits {4};
+        static constexpr std::size_t sl_count {std::size_t(1) << sl_bits};
+        static constexpr std::size_t fl_count {std::numeric_limits<std::size_t>::digits - sl_bits + 1};
+
+        struct Block
+        {
+            std::size_t offset;
+            std::size_t size;
+            std::uint32_t prev_phys {invalid_node};
+            std::uint32_t next_phys {invalid_node};
+            std::uint32_t prev_free {invalid_node};
+            std::uint32_t next_free {invalid_node};
+            bool free {false};
+        };
+
+        std::vector<Block> blocks;
+        std::vector<std::uint32_t> unused_nodes;
+        std::array<std::array<std::uint32_t,sl_count>,fl_count> free_heads;
+        std::size_t fl_map {0};
+        std::array<std::uint32_t,fl_count> sl_maps {};
+        std::size_t capacity;
+        std::size_t free_size;
+
+        /**
+         * @brief the size class of size, sizes below sl_count get one class each
+         *
+         * @param size
+         * @param fl
+         * @param sl
+         */
+        static void mapping(std::size_t size,std::size_t& fl,std::size_t& sl) noexcept
+        {
+            if(size < sl_count)
+            {
+                fl = 0;
+                sl = size;
+                return;
+            }
+            const std::size_t log2 {static_cast<std::size_t>(std::bit_width(size)) - 1};
+            sl = (size >> (log2 - sl_bits)) ^ sl_count;
+            fl = log2 - sl_bits + 1;
+        }
+
+        /**
+         * @brief round size up to the next size class, any free block in that class is large enough
+         *
+         * @param size
+         * @return std::size_t
+         */
+        static std::size_t round_up(std::size_t size) noexcept
+        {
+            if(size < sl_count)
+                return size;
+            const std::size_t log2 {static_cast<std::size_t>(std::bit_width(size)) - 1};
+            return size + (std::size_t(1) << (log2 - sl_bits)) - 1;
+        }
+
+        std::uint32_t new_node(std::size_t offset,std::size_t size) noexcept(false)
+        {
+            if(!unused_nodes.empty())
+            {
+                const std::uint32_t node {unused_nodes.back()};
+                unused_nodes.pop_back();
+                blocks[node] = Block {offset,size};
+                return node;
+            }
+            blocks.push_back(Block {offset,size});
+            return static_cast<std::uint32_t>(blocks.size() - 1);
+        }
+
+        void insert_free(std::uint32_t node) noexcept
+        {
+            Block& block {blocks[node]};
+            std::size_t fl,sl;
+            mapping(block.size,fl,sl);
+
+            block.free = true;
+            block.prev_free = invalid_node;
+            block.next_free = free_heads[fl][sl];
+            if(block.next_free != invalid_node)
+                blocks[block.next_free].prev_free = node;
+            free_heads[fl][sl] = node;
+            fl_map |= std::size_t(1) << fl;
+            sl_maps[fl] |= std::uint32_t(1) << sl;
+        }
+
+        void remove_free(std::uint32_t node) noexcept
+        {
+            Block& block {blocks[node]};
+            std::size_t fl,sl;
+            mapping(block.size,fl,sl);
+
+            if(block.prev_free != invalid_node)
+                blocks[block.prev_free].next_free = block.next_free;
+            else
+                free_heads[fl][sl] = block.next_free;
+            if(block.next_free != invalid_node)
+                blocks[block.next_free].prev_free = block.prev_free;
+
+            if(free_heads[fl][sl] == invalid_node)
+            {
+                sl_maps[fl] &= ~(std::uint32_t(1) << sl);
+                if(sl_maps[fl] == 0)
+                    fl_map &= ~(std::size_t(1) << fl);
+            }
+            block.free = false;
+        }
+
+        /**
+         * @brief find a free block of at least size, invalid_node if there is none
+         *
+         * @param size
+         * @return std::uint32_t
+         */
+        std::uint32_t find_free(std::size_t size) const noexcept
+        {
+            std::size_t fl,sl;
+
+            // the class of size itself may hold a block that fits, such as a freed block of the same size
+            mapping(size,fl,sl);
+            const std::uint32_t head {free_heads[fl][sl]};
+            if(head != invalid_node && blocks[head].size >= size)
+                return head;
+
+            mapping(round_up(size),fl,sl);
+            if(fl >= fl_count)
+                return invalid_node;
+
+            std::uint32_t sl_map {sl_maps[fl] & (~std::uint32_t(0) << sl)};
+            if(sl_map == 0)
+            {
+                const std::size_t map {fl + 1 < fl_count ? fl_map & (~std::size_t(0) << (fl + 1)) : 0};
+                if(map == 0)
+                    return invalid_node;
+                fl = std::countr_zero(map);
+                sl_map = sl_maps[fl];
+            }
+            return free_heads[fl][std::countr_zero(sl_map)];
+        }
+
+        /**
+         * @brief merge the free block right after node into node
+         *
+         * @param node
+         * @param next
+         */
+        void absorb(std::uint32_t node,std::uint32_t next) noexcept
+        {
+            Block& block {blocks[node]};
+            const Block& absorbed {blocks[next]};
+            block.size += absorbed.size;
+            block.next_phys = absorbed.next_phys;
+            if(block.next_phys != invalid_node)
+                blocks[block.next_phys].prev_phys = node;
+            unused_nodes.push_back(next);
+        }
+
+    public:
+        explicit RangeAllocator(std::size_t capacity) noexcept(false)
+            : capacity(capacity),free_size(capacity)
+        {
+            for(auto& heads : free_heads)
+                heads.fill(invalid_node);
+            if(capacity != 0)
+                insert_free(new_node(0,capacity));
+        }
+
+        /**
+         * @brief take size units, check is_valid() on the result
+         *
+         * @param size  must not be 0
+         * @return Allocation
+         */
+        Allocation allocate(std::size_t size) noexcept(false)
+        {
+            if(size == 0)
+                return {};
+            const std::uint32_t node {find_free(size)};
+            if(node == invalid_node)
+                return {};
+
+            remove_free(node);
+            if(blocks[node].size > size)
+            {
+                // the rest stays free, right after the allocation
+                const std::uint32_t rest {new_node(blocks[node].offset + size,blocks[node].size - size)};
+                Block& block {blocks[node]};
+                blocks[rest].prev_phys = node;
+                blocks[rest].next_phys = block.next_phys;
+                if(block.next_phys != invalid_node)
+                    blocks[block.next_phys].prev_phys = rest;
+                block.next_phys = rest;
+                block.size = size;
+                insert_free(rest);
+            }
+
+            free_size -= size;
+            return Allocation {blocks[node].offset,size,node};
+        }
+
+        /**
+         * @brief give an allocation back, merging it with its free neighbours
+         *
+         * @param allocation
+         */
+        void free(const Allocation& allocation) noexcept
+        {
+            if(!allocation.is_valid())
+                return;
+
+            std::uint32_t node {allocation.node};
+            free_size += blocks[node].size;
+
+            const std::uint32_t next {blocks[node].next_phys};
+            if(next != invalid_node && blocks[next].free)
+            {
+                remove_free(next);
+                absorb(node,next);
+            }
+            const std::uint32_t prev {blocks[node].prev_phys};
+            if(prev != invalid_node && blocks[prev].free)
+            {
+                remove_free(prev);
+                absorb(prev,node);
+                node = prev;
+            }
+            insert_free(node);
+        }
+
+        std::size_t get_capacity() const noexcept
+        {
+            return capacity;
+        }
+
+        std::size_t get_free_size() const noexcept
+        {
+            return free_size;
+        }
+    };
+}
\ No newline at end of file
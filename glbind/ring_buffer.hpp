@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace graphics
+{
+    /**
+     * @brief bounded lock-free queue, any thread may push or pop
+     * @note  push never blocks and never allocates, it fails when the queue is full
+     *
+     * @tparam T        copyable element type
+     * @tparam capacity must be a power of two
+     */
+    template <typename T,std::size_t capacity>
+    class RingBuffer
+    {
+        static_assert(capacity != 0 && (capacity & (capacity - 1)) == 0,"RingBuffer capacity must be a power of two");
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        std::array<Cell,capacity> cells;
+        alignas(64) std::atomic<std::size_t> head {0};
+        alignas(64) std::atomic<std::size_t> tail {0};
+
+    public:
+        RingBuffer() noexcept
+        {
+            for(std::size_t i = 0;i < capacity;i++)
+                cells[i].sequence.store(i,std::memory_order_relaxed);
+        }
+
+        RingBuffer(RingBuffer&) = delete;
+
+        /**
+         * @brief add an element at the back
+         *
+         * @param value
+         * @return true
+         * @return false    the queue is full, value is dropped
+         */
+        bool push(const T& value) noexcept
+        {
+            std::size_t pos {head.load(std::memory_order_relaxed)};
+            while(true)
+            {
+                Cell& cell {cells[pos & (capacity - 1)]};
+                const std::size_t sequence {cell.sequence.load(std::memory_order_acquire)};
+                const auto diff {static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos)};
+                if(diff == 0)
+                {
+                    if(head.compare_exchange_weak(pos,pos + 1,std::memory_order_relaxed))
+                    {
+                        cell.value = value;
+                        cell.sequence.store(pos + 1,std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if(diff < 0)
+                    return false;
+                else
+                    pos = head.load(std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief take the element at the front
+         *
+         * @param value
+         * @return true
+         * @return false    the queue is empty, value is untouched
+         */
+        bool pop(T& value) noexcept
+        {
+            std::size_t pos {tail.load(std::memory_order_relaxed)};
+            while(true)
+            {
+                Cell& cell {cells[pos & (capacity - 1)]};
+                const std::size_t sequence {cell.sequence.load(std::memory_order_acquire)};
+                const auto diff {static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1)};
+                if(diff == 0)
+                {
+                    if(tail.compare_exchange_weak(pos,pos + 1,std::memory_order_relaxed))
+                    {
+                        value = cell.value;
+                        cell.sequence.store(pos + capacity,std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if(diff < 0)
+                    return false;
+                else
+                    pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        static constexpr std::size_t get_capacity() noexcept
+        {
+            return capacity;
+        }
+    };
+}
\ No newline at end of file
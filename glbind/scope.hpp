@@ -1,143 +1,199 @@
 #pragma once
 
+#include "context.hpp"
 #include <glad/glad.h>
 #include <functional>
+#include <concepts>
+#include <utility>
 #include <array>
+#include <source_location>
+#include <iostream>
 
 namespace graphics
 {
-    class StatusManager
+#if defined(GLBIND_TRUSTED_SCOPE) && defined(GLBIND_VALIDATE_SCOPE)
+#error "GLBIND_TRUSTED_SCOPE and GLBIND_VALIDATE_SCOPE can not be used together"
+#endif
+
+    /**
+     * @brief a piece of status a Scope did not put back
+     *
+     */
+    struct ScopeLeak
+    {
+        std::source_location location;  // where the Scope was opened
+        Field field;
+        bool clobbered;                 // changed by raw OpenGL calls, glbind did not see it
+    };
+
+    using ScopeLeakHandler = void (*)(const ScopeLeak& leak);
+
+    inline void print_scope_leak(const ScopeLeak& leak) noexcept
+    {
+        std::cerr << leak.location.file_name() << ':' << leak.location.line() << ": "
+                  << (leak.clobbered ? "Scope saw a raw OpenGL change of " : "Scope leaked ") << field_name(leak.field) << std::endl;
+    }
+
+    /**
+     * @brief called for every leak found by GLBIND_VALIDATE_SCOPE builds, prints to std::cerr by default
+     *
+     */
+    inline ScopeLeakHandler scope_leak_handler {print_scope_leak};
+
+    inline void set_scope_leak_handler(ScopeLeakHandler handler) noexcept
+    {
+        scope_leak_handler = handler;
+    }
+
+    /**
+     * @brief compare the status after a Scope with the one before it and report every difference
+     *
+     * @tparam states   the groups the Scope is supposed to put back
+     * @param location  where the Scope was opened
+     * @param before    the status queried when the Scope was opened
+     */
+    template <State states>
+    inline void validate_scope(const std::source_location& location,const StatusRecord& before) noexcept
+    {
+        StatusRecord after;
+        StatusCache::query(after);
+
+        bool clobbered {false};
+        for(unsigned int i = 0;i < field_count;i++)
+        {
+            const Field field {static_cast<Field>(i)};
+            if(fields_of(states) & field_bit(field) && !StatusCache::same_field(field,before,after))
+                scope_leak_handler(ScopeLeak{location,field,false});
+            if(!StatusCache::same_field(field,status_cache().get(),after))
+            {
+                scope_leak_handler(ScopeLeak{location,field,true});
+                clobbered = true;
+            }
+        }
+
+        // report each raw change once
+        if(clobbered)
+            status_cache().sync();
+    }
+
+    /**
+     * @brief save some groups of the opengl status and restore them when destroyed, whatever the build
+     * @note  glbind wraps its own temporary binds in it, so GLBIND_TRUSTED_SCOPE and GLBIND_VALIDATE_SCOPE
+     *        only change what the Scopes of the caller do
+     * @warning throw std::runtime_error when nested deeper than StatusCache::max_scope_depth
+     *
+     * @tparam states the groups to save and restore
+     */
+    template <State states = State::All>
+    class StatusRestorer
     {
     private:
-        struct
+        StatusCache& cache;
+
+    public:
+        StatusRestorer() noexcept(false)
+            : cache {status_cache()}
         {
-            int vao_id;
-            int vbo_id;
-            int ebo_id;
-            int texture_2d_id;
-            int framebuffer_id;
-            int renderbuffer_id;
-            int program_id;
-            int cullface_mode;
-            int polygon_mode_front;
-            int polugon_mode_back;
-            int depth_func;
-            int stencil_func;
-            int stencil_ref;
-            int stencil_value_mask;
-            int stencil_write_mask;
-            int stencil_fail_op;
-            int stencil_depth_fail_op;
-            int stencil_pass_op;
-            int stencil_back_func;
-            int stencil_back_ref;
-            int stencil_back_value_mask;
-            int stencil_back_fail_op;
-            int stencil_back_depth_fail_op;
-            int stencil_back_pass_op;
-            int stencil_clear_value;
-            bool stencil_test;
-            bool depth_test;
-            bool depth_writemask;
-            bool blend_test;
-            bool scissor_test;
-            float point_size;
-            float line_width;
-            std::array<int,4> viewport;
-            std::array<float,2> depth_range;
-            //std::array<float,4> clear_color;
-            std::array<float,4> blend_color;
-        } status_record;
+            cache.begin_scope();
+        }
+
+        StatusRestorer(StatusRestorer&) = delete;
+
+        ~StatusRestorer() noexcept
+        {
+            cache.end_scope<states>();
+        }
+    };
+
+    /**
+     * @brief save some groups of the opengl status and restore them when destroyed
+     * @note  nothing is copied up front, the status cache records each field the first time glbind changes it.
+     *        GLBIND_TRUSTED_SCOPE builds save and restore nothing, the caller keeps the status clean.
+     *        GLBIND_VALIDATE_SCOPE builds restore nothing either but report what was left changed.
+     *        the binds glbind makes for itself are always put back, see StatusRestorer
+     * @warning throw std::runtime_error when nested deeper than StatusCache::max_scope_depth
+     * 
+     * @tparam states the groups to save and restore
+     */
+    template <State states = State::All>
+    class StatusManager
+    {
+#if defined(GLBIND_VALIDATE_SCOPE)
+    private:
+        std::source_location location;
+        StatusRecord before;
+#elif !defined(GLBIND_TRUSTED_SCOPE)
+    private:
+        StatusCache& cache;
+#endif
 
     public:
-        StatusManager() noexcept
+#if defined(GLBIND_VALIDATE_SCOPE)
+        explicit StatusManager(std::source_location location = std::source_location::current()) noexcept(false)
+            : location {location}
+        {
+            StatusCache::query(before);
+#elif defined(GLBIND_TRUSTED_SCOPE)
+        explicit StatusManager([[maybe_unused]] std::source_location location = std::source_location::current()) noexcept
         {
-            int polygon_mode[2];
-            glGetIntegerv(GL_POLYGON_MODE, polygon_mode);
-            status_record.polygon_mode_front = polygon_mode[0];
-            status_record.polugon_mode_back = polygon_mode[1];
-
-            glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &status_record.vao_id);
-            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &status_record.vbo_id);
-            glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &status_record.ebo_id);
-            glGetIntegerv(GL_TEXTURE_BINDING_2D,&status_record.texture_2d_id);
-            glGetIntegerv(GL_FRAMEBUFFER_BINDING,&status_record.framebuffer_id);
-            glGetIntegerv(GL_RENDERBUFFER_BINDING,&status_record.renderbuffer_id);
-            glGetIntegerv(GL_CURRENT_PROGRAM,&status_record.program_id);
-            glGetIntegerv(GL_VIEWPORT,status_record.viewport.data());
-            glGetIntegerv(GL_STENCIL_FUNC,&status_record.stencil_func);
-            glGetIntegerv(GL_STENCIL_REF,&status_record.stencil_ref);
-            glGetIntegerv(GL_STENCIL_VALUE_MASK,&status_record.stencil_value_mask);
-            glGetIntegerv(GL_STENCIL_WRITEMASK,&status_record.stencil_write_mask);
-            glGetIntegerv(GL_STENCIL_FAIL,&status_record.stencil_fail_op);
-            glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL,&status_record.stencil_depth_fail_op);
-            glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS,&status_record.stencil_pass_op);
-            glGetIntegerv(GL_CULL_FACE_MODE,&status_record.cullface_mode);
-            glGetBooleanv(GL_DEPTH_TEST,reinterpret_cast<GLboolean*>(&status_record.depth_test));
-            glGetBooleanv(GL_STENCIL_TEST,reinterpret_cast<GLboolean*>(&status_record.stencil_test));
-            glGetBooleanv(GL_BLEND,reinterpret_cast<GLboolean*>(&status_record.blend_test));
-            glGetBooleanv(GL_SCISSOR_TEST,reinterpret_cast<GLboolean*>(&status_record.scissor_test));
-            glGetFloatv(GL_POINT_SIZE,&status_record.point_size);
-            glGetFloatv(GL_LINE_WIDTH,&status_record.line_width);
-            //glGetFloatv(GL_COLOR_CLEAR_VALUE,status_record.clear_color.data());
-            glGetIntegerv(GL_DEPTH_FUNC, &status_record.depth_func);
-            glGetFloatv(GL_DEPTH_RANGE, status_record.depth_range.data());
-            glGetBooleanv(GL_DEPTH_WRITEMASK,reinterpret_cast<GLboolean*>(&status_record.depth_writemask));
-            glGetIntegerv(GL_STENCIL_BACK_FUNC, &status_record.stencil_back_func);
-            glGetIntegerv(GL_STENCIL_BACK_REF, &status_record.stencil_back_ref);
-            glGetIntegerv(GL_STENCIL_BACK_VALUE_MASK, &status_record.stencil_back_value_mask);
-            glGetIntegerv(GL_STENCIL_BACK_FAIL, &status_record.stencil_back_fail_op);
-            glGetIntegerv(GL_STENCIL_BACK_PASS_DEPTH_FAIL, &status_record.stencil_back_depth_fail_op);
-            glGetIntegerv(GL_STENCIL_BACK_PASS_DEPTH_PASS, &status_record.stencil_back_pass_op);
-            glGetIntegerv(GL_STENCIL_CLEAR_VALUE, &status_record.stencil_clear_value);
-            glGetFloatv(GL_BLEND_COLOR, status_record.blend_color.data());
+#else
+        explicit StatusManager([[maybe_unused]] std::source_location location = std::source_location::current()) noexcept(false)
+            : cache {status_cache()}
+        {
+            cache.begin_scope();
+#endif
+#ifdef GLAD_INSTRUMENT
+            call_accounting().push_scope(location);
+#endif
         }
 
+        StatusManager(StatusManager&) = delete;
+
+        /**
+         * @brief restore only the fields changed by glbind inside this scope
+         * 
+         */
         ~StatusManager() noexcept
         {
-            glBindVertexArray(status_record.vao_id);
-            glBindBuffer(GL_ARRAY_BUFFER, status_record.vbo_id);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, status_record.ebo_id);
-            glBindTexture(GL_TEXTURE_2D, status_record.texture_2d_id);
-            glBindFramebuffer(GL_FRAMEBUFFER, status_record.framebuffer_id);
-            glBindRenderbuffer(GL_RENDERBUFFER, status_record.renderbuffer_id);
-            glUseProgram(status_record.program_id);
-            glViewport(status_record.viewport[0], status_record.viewport[1], status_record.viewport[2], status_record.viewport[3]);
-            glStencilFunc(status_record.stencil_func, status_record.stencil_ref, status_record.stencil_value_mask);
-            glStencilMaskSeparate(GL_FRONT, status_record.stencil_write_mask);
-            glStencilMaskSeparate(GL_BACK, status_record.stencil_write_mask);
-            glStencilOpSeparate(GL_FRONT, status_record.stencil_fail_op, status_record.stencil_depth_fail_op, status_record.stencil_pass_op);
-            glStencilOpSeparate(GL_BACK, status_record.stencil_fail_op, status_record.stencil_depth_fail_op, status_record.stencil_pass_op);
-            glCullFace(status_record.cullface_mode);
-            glPolygonMode(GL_FRONT, status_record.polygon_mode_front);
-            glPolygonMode(GL_BACK, status_record.polugon_mode_back);
-            status_record.depth_test ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
-            status_record.stencil_test ? glEnable(GL_STENCIL_TEST) : glDisable(GL_STENCIL_TEST);
-            status_record.blend_test ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
-            status_record.scissor_test ? glEnable(GL_SCISSOR_TEST) : glDisable(GL_SCISSOR_TEST);
-            glPointSize(status_record.point_size);
-            glLineWidth(status_record.line_width);
-            //glClearColor(status_record.clear_color[0], status_record.clear_color[1], status_record.clear_color[2], status_record.clear_color[3]);
-            glDepthFunc(status_record.depth_func);
-            glDepthRange(status_record.depth_range[0], status_record.depth_range[1]);
-            glDepthMask(status_record.depth_writemask);
-            glStencilFuncSeparate(GL_BACK, status_record.stencil_back_func, status_record.stencil_back_ref, status_record.stencil_back_value_mask);
-            glStencilMaskSeparate(GL_BACK, status_record.stencil_write_mask);
-            glStencilOpSeparate(GL_BACK, status_record.stencil_back_fail_op, status_record.stencil_back_depth_fail_op, status_record.stencil_back_pass_op);
-            glClearStencil(status_record.stencil_clear_value);
-            glBlendColor(status_record.blend_color[0], status_record.blend_color[1], status_record.blend_color[2], status_record.blend_color[3]);
+#if defined(GLBIND_VALIDATE_SCOPE)
+            validate_scope<states>(location,before);
+#elif !defined(GLBIND_TRUSTED_SCOPE)
+            // before pop_section(), the calls restoring the status belong to this Scope
+            cache.end_scope<states>();
+#endif
+#ifdef GLAD_INSTRUMENT
+            call_accounting().pop_section();
+#endif
         }
     };
 
     /**
      * @brief Clear up some opengl status after calling func.
      * 
-     * @param func the (lambda) func you wish to call
+     * @tparam states   the groups of status to clear up, all of them by default
+     * @tparam Func     any invocable, it is called in place and never copied
+     * @param func      the (lambda) func you wish to call
+     * @param location  the call site, glbind names the Scope by it
+     */
+    template <State states = State::All,std::invocable Func>
+    inline void Scope(Func&& func,std::source_location location = std::source_location::current())
+    {
+        StatusManager<states> status_manager(location);
+        std::forward<Func>(func)();
+    }
+
+    /**
+     * @brief call func and restore some opengl status, the same in every build. glbind uses it around its own binds
+     *
+     * @tparam states   the groups of status to restore
+     * @tparam Func     any invocable, it is called in place and never copied
+     * @param func
      */
-    inline void Scope(std::function<void()> func)
+    template <State states,std::invocable Func>
+    inline void RestoreScope(Func&& func)
     {
-        StatusManager status_manager;
-        func();
+        StatusRestorer<states> restorer;
+        std::forward<Func>(func)();
     }
 
     /**
@@ -151,7 +207,7 @@ namespace graphics
      */
     [[deprecated]] inline void Scope(int x,int y,int w,int h,std::function<void()> func)
     {
-        glViewport(x,y,w,h);
+        status_cache().set_viewport(x,y,w,h);
         Scope(func);
     }
 
@@ -170,15 +226,15 @@ namespace graphics
      */
     [[deprecated]] inline void Scope(int x,int y,int w,int h,float r,float g,float b,float a,std::function<void()> func)
     {
-        glViewport(x,y,w,h);
+        status_cache().set_viewport(x,y,w,h);
         glClearColor(r,g,b,a);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
         Scope(func);
     }
 
-    void set_viewport(int x,int y,int w,int h) noexcept
+    inline void set_viewport(int x,int y,int w,int h) noexcept
     {
-        glViewport(x,y,w,h);
+        status_cache().set_viewport(x,y,w,h);
     }
 
     enum class PloygonModes
@@ -188,20 +244,61 @@ namespace graphics
         Fill = GL_FILL
     };
 
+    /**
+     * @brief set the polygon mode of front faces only
+     * @warning the core profile can not give the faces different modes, there it only works when the back face
+     *          already has this mode. use set_polygon_model()
+     *
+     * @param mode
+     */
     inline void set_front_ploygon_model(PloygonModes mode) noexcept
     {
-        glPolygonMode(GL_FRONT,static_cast<GLint>(mode));
+        status_cache().set_polygon_mode(GL_FRONT,static_cast<GLint>(mode));
     }
 
+    /**
+     * @brief set the polygon mode of back faces only
+     * @warning the core profile can not give the faces different modes, there it only works when the front face
+     *          already has this mode. use set_polygon_model()
+     *
+     * @param mode
+     */
     inline void set_back_ploygon_model(PloygonModes mode) noexcept
     {
-        glPolygonMode(GL_BACK,static_cast<GLint>(mode));
+        status_cache().set_polygon_mode(GL_BACK,static_cast<GLint>(mode));
     }
 
     inline void set_ploygon_model(PloygonModes mode) noexcept
     {
-        set_front_ploygon_model(mode);
-        set_back_ploygon_model(mode);
+        status_cache().set_polygon_mode(GL_FRONT_AND_BACK,static_cast<GLint>(mode));
+    }
+
+    using PolygonModes = PloygonModes;
+
+    inline void set_polygon_model(PolygonModes mode) noexcept
+    {
+        status_cache().set_polygon_mode(GL_FRONT_AND_BACK,static_cast<GLint>(mode));
+    }
+
+    inline void set_line_width(float width) noexcept
+    {
+        status_cache().set_line_width(width);
+    }
+
+    /**
+     * @brief restart the primitive at every index equal to index, see ElementBuffer for a restart index draw() manages
+     *
+     * @param index
+     */
+    inline void enable_primitive_restart(unsigned int index) noexcept
+    {
+        status_cache().set_primitive_restart(true);
+        status_cache().set_primitive_restart_index(index);
+    }
+
+    inline void disable_primitive_restart() noexcept
+    {
+        status_cache().set_primitive_restart(false);
     }
 
     enum class TestFuncType
@@ -218,32 +315,32 @@ namespace graphics
 
     inline void set_depth_mask(bool mask) noexcept
     {
-        glDepthMask(mask);
+        status_cache().set_depth_mask(mask);
     }
 
     inline void set_depth_func(TestFuncType func_type) noexcept
     {
-        glDepthFunc(static_cast<GLint>(func_type));
+        status_cache().set_depth_func(static_cast<GLint>(func_type));
     }
 
     template <TestFuncType func_type>
     inline void enable_depth_test(bool read_only = false) noexcept
     {
-        glEnable(GL_DEPTH_TEST);
+        status_cache().set_depth_test(true);
         set_depth_mask(!read_only);
         set_depth_func(func_type);
     }
 
     inline void enable_depth_test(bool read_only = false) noexcept
     {
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(!read_only);
-        glDepthFunc(GL_LESS);
+        status_cache().set_depth_test(true);
+        status_cache().set_depth_mask(!read_only);
+        status_cache().set_depth_func(GL_LESS);
     }
 
     inline void disable_depth_test() noexcept
     {
-        glDisable(GL_DEPTH_TEST);
+        status_cache().set_depth_test(false);
     }
 
     enum class StencilOpType
@@ -260,27 +357,27 @@ namespace graphics
 
     inline void set_stencil_func(TestFuncType func_type,int ref,unsigned int mask) noexcept
     {
-        glStencilFunc(static_cast<GLint>(func_type),ref,mask);
+        status_cache().set_stencil_func(static_cast<GLint>(func_type),ref,mask);
     }
 
     inline void set_stencil_mask(unsigned int mask) noexcept
     {
-        glStencilMask(mask);
+        status_cache().set_stencil_mask(mask);
     }
 
     inline void set_stencil_op(StencilOpType fail_op,StencilOpType deep_test_fail_op,StencilOpType pass_op) noexcept
     {
-        glStencilOp(static_cast<GLint>(fail_op),static_cast<GLint>(deep_test_fail_op),static_cast<GLint>(pass_op));
+        status_cache().set_stencil_op(static_cast<GLint>(fail_op),static_cast<GLint>(deep_test_fail_op),static_cast<GLint>(pass_op));
     }
 
     inline void enable_stencil_test() noexcept
     {
-        glEnable(GL_STENCIL_TEST);
+        status_cache().set_stencil_test(true);
     }
 
     inline void disable_stencil_test() noexcept
     {
-        glDisable(GL_STENCIL_TEST);
+        status_cache().set_stencil_test(false);
     }
 
     enum class BlendFuncType
@@ -303,18 +400,66 @@ namespace graphics
 
     inline void enable_blend(BlendFuncType src_factor,BlendFuncType dst_factor) noexcept
     {
-        glEnable(GL_BLEND);
-        glBlendFunc(static_cast<GLenum>(src_factor),static_cast<GLenum>(dst_factor));
+        status_cache().set_blend(true);
+        status_cache().set_blend_func(static_cast<GLint>(src_factor),static_cast<GLint>(dst_factor),static_cast<GLint>(src_factor),static_cast<GLint>(dst_factor));
     }
 
     inline void enable_blend(BlendFuncType src_rgb,BlendFuncType dst_rgb,BlendFuncType src_alpha,BlendFuncType dst_alpha) noexcept
     {
-        glEnable(GL_BLEND);
-        glBlendFuncSeparate(static_cast<GLenum>(src_rgb),static_cast<GLenum>(dst_rgb),static_cast<GLenum>(src_alpha),static_cast<GLenum>(dst_alpha));
+        status_cache().set_blend(true);
+        status_cache().set_blend_func(static_cast<GLint>(src_rgb),static_cast<GLint>(dst_rgb),static_cast<GLint>(src_alpha),static_cast<GLint>(dst_alpha));
     }
 
     inline void disable_blend() noexcept
     {
-        glDisable(GL_BLEND);
+        status_cache().set_blend(false);
+    }
+
+    inline void set_blend_color(float r,float g,float b,float a) noexcept
+    {
+        status_cache().set_blend_color(r,g,b,a);
+    }
+
+    enum class CullFaceType
+    {
+        Front = GL_FRONT,
+        Back = GL_BACK,
+        FrontAndBack = GL_FRONT_AND_BACK
+    };
+
+    enum class CullFrontFaceType
+    {
+        CW = GL_CW,
+        CCW = GL_CCW
+    };
+
+    inline void enable_cull_face() noexcept
+    {
+        status_cache().set_cull_face_test(true);
+    }
+
+    inline void disable_cull_face() noexcept
+    {
+        status_cache().set_cull_face_test(false);
+    }
+
+    /**
+     * @brief choose which faces are culled, back faces by default
+     *
+     * @param face_type
+     */
+    inline void set_cull_face_type(CullFaceType face_type) noexcept
+    {
+        status_cache().set_cull_face(static_cast<GLint>(face_type));
+    }
+
+    /**
+     * @brief choose the winding of front faces, counter-clockwise by default
+     *
+     * @param front_face_type
+     */
+    inline void set_front_face_type(CullFrontFaceType front_face_type) noexcept
+    {
+        status_cache().set_front_face(static_cast<GLint>(front_face_type));
     }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <glm/ext/vector_float3.hpp>
 #include <glm/ext/vector_float4.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "context.hpp"
 #include <glad/glad.h>
 #include <string>
 #include <memory>
@@ -49,6 +50,7 @@ namespace graphics
         {
             const char* source = glsl.data();
             shader_id = glCreateShader(GL_VERTEX_SHADER);
+            set_operation("Shader::compile_vshader",shader_id);
             glShaderSource(shader_id,1,&source,nullptr);
             glCompileShader(shader_id);
 
@@ -65,6 +67,7 @@ namespace graphics
         {
             const char* source = glsl.data();
             shader_id = glCreateShader(GL_FRAGMENT_SHADER);
+            set_operation("Shader::compile_fshader",shader_id);
             glShaderSource(shader_id,1,&source,nullptr);
             glCompileShader(shader_id);
 
@@ -198,6 +201,7 @@ namespace graphics
         Program(const VShader& vshader,const FShader& fshader) noexcept
         {
             program_id = glCreateProgram();
+            set_operation("Program::Program",program_id);
             glAttachShader(program_id,vshader.get_shader_id());
             glAttachShader(program_id,fshader.get_shader_id());
             glLinkProgram(program_id);
@@ -224,7 +228,7 @@ namespace graphics
          */
         void use() const noexcept
         {
-            glUseProgram(program_id);
+            status_cache().use_program(program_id);
         }
 
         /**
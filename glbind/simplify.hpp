@@ -0,0 +1,441 @@
+#pragma once
+
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace graphics
+{
+    struct SimplifyOptions
+    {
+        std::size_t position_offset {0};    // by count, 3 floats
+        float attribute_weight {1.0f};      // how much the other floats of a vertex cost to lose, against positions scaled to the mesh size
+        bool lock_border {true};            // keep the vertices of open edges, so meshes sharing a border stay sealed
+    };
+
+    /**
+     * @brief one level of detail: indices over the same vertices as the source mesh
+     *
+     */
+    struct LodLevel
+    {
+        std::vector<unsigned int> indices;
+        float error {0.0f};     // estimated distance the surface moved from the source mesh, in mesh units
+    };
+
+    /**
+     * @brief a symmetric 4x4 matrix summing squared distances to planes, and the total weight of the planes
+     *
+     */
+    struct Quadric
+    {
+        std::array<double,10> q {};
+        double weight {0.0};
+
+        static Quadric from_plane(double a,double b,double c,double d,double weight) noexcept
+        {
+            Quadric quadric;
+            quadric.q = {a * a * weight,a * b * weight,a * c * weight,a * d * weight,b * b * weight,b * c * weight,b * d * weight,
+                c * c * weight,c * d * weight,d * d * weight};
+            quadric.weight = weight;
+            return quadric;
+        }
+
+        Quadric& operator+=(const Quadric& other) noexcept
+        {
+            for(std::size_t i = 0;i < q.size();i++)
+                q[i] += other.q[i];
+            weight += other.weight;
+            return *this;
+        }
+
+        /**
+         * @brief the weighted mean squared distance from p to the planes
+         *
+         */
+        double error(const std::array<double,3>& p) const noexcept
+        {
+            const double x {p[0]},y {p[1]},z {p[2]};
+            const double sum {q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+                + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+                + q[7] * z * z + 2 * q[8] * z
+                + q[9]};
+            return weight == 0.0 ? 0.0 : std::max(sum / weight,0.0);
+        }
+    };
+
+    /**
+     * @brief reduce a triangle list by quadric error metric edge collapses, vertices are never moved or created
+     *        so the result indexes the same vertex buffer
+     * @note  a vertex is only collapsed onto a neighbour. vertices on an attribute seam (several vertices at one position)
+     *        are kept, and so are border vertices unless options.lock_border is false. collapses flipping a triangle are skipped
+     * @warning throw std::out_of_range when the position does not fit in vertex_len or an index is past the vertices
+     *
+     * @param indices               a triangle list
+     * @param vertices              interleaved, as given to VertexBuffer
+     * @param vertex_len            by count
+     * @param target_index_count    stop once the result has no more indices than this
+     * @param target_error          stop before the surface moves further than this, in mesh units
+     * @param options
+     * @return LodLevel
+     */
+    inline LodLevel simplify(std::span<const unsigned int> indices,std::span<const float> vertices,std::size_t vertex_len,std::size_t target_index_count,
+        float target_error = std::numeric_limits<float>::max(),const SimplifyOptions& options = {}) noexcept(false)
+    {
+        if(vertex_len == 0 || options.position_offset + 3 > vertex_len)
+            throw std::out_of_range("position out of vertex length");
+        const std::size_t vertex_count {vertices.size() / vertex_len};
+        for(std::size_t i = 0;i < indices.size() / 3 * 3;i++)
+        {
+            if(indices[i] >= vertex_count)
+                throw std::out_of_range("index out of vertex count");
+        }
+
+        LodLevel level;
+        for(std::size_t t = 0;t < indices.size() / 3;t++)
+        {
+            const unsigned int a {indices[t * 3]},b {indices[t * 3 + 1]},c {indices[t * 3 + 2]};
+            if(a != b && b != c && c != a)
+                level.indices.insert(level.indices.end(),{a,b,c});
+        }
+        std::vector<unsigned int>& current {level.indices};
+        if(current.size() <= target_index_count || vertex_count == 0)
+            return level;
+
+        // positions scaled into a unit box, so errors and attribute weights do not depend on the mesh size
+        const auto raw {[&](std::size_t v,std::size_t axis)
+        {
+            return vertices[v * vertex_len + options.position_offset + axis];
+        }};
+        std::array<float,3> low {raw(0,0),raw(0,1),raw(0,2)};
+        std::array<float,3> high {low};
+        for(std::size_t v = 1;v < vertex_count;v++)
+        {
+            for(std::size_t axis = 0;axis < 3;axis++)
+            {
+                low[axis] = std::min(low[axis],raw(v,axis));
+                high[axis] = std::max(high[axis],raw(v,axis));
+            }
+        }
+        const double extent {std::max({double(high[0]) - low[0],double(high[1]) - low[1],double(high[2]) - low[2],1e-30})};
+        std::vector<std::array<double,3>> positions(vertex_count);
+        for(std::size_t v = 0;v < vertex_count;v++)
+        {
+            for(std::size_t axis = 0;axis < 3;axis++)
+                positions[v][axis] = (raw(v,axis) - low[axis]) / extent;
+        }
+
+        // vertices sharing a position are one corner of the surface, split by their attributes
+        std::vector<unsigned int> corner(vertex_count);
+        std::vector<bool> locked(vertex_count,false);
+        {
+            std::unordered_map<std::uint64_t,std::vector<unsigned int>> buckets;
+            buckets.reserve(vertex_count);
+            for(unsigned int v = 0;v < vertex_count;v++)
+            {
+                std::uint64_t h {0xCBF29CE484222325ull};
+                for(std::size_t axis = 0;axis < 3;axis++)
+                    h = (h ^ std::bit_cast<std::uint32_t>(raw(v,axis) == 0.0f ? 0.0f : raw(v,axis))) * 0x100000001B3ull;
+                corner[v] = v;
+                for(const unsigned int other : buckets[h])
+                {
+                    if(raw(other,0) == raw(v,0) && raw(other,1) == raw(v,1) && raw(other,2) == raw(v,2))
+                    {
+                        corner[v] = corner[other];
+                        locked[v] = locked[other] = true;
+                        break;
+                    }
+                }
+                buckets[h].push_back(v);
+            }
+        }
+        if(options.lock_border)
+        {
+            // an edge of the welded surface used by a single triangle is open
+            std::vector<std::uint64_t> edges;
+            edges.reserve(current.size());
+            for(std::size_t i = 0;i < current.size();i += 3)
+            {
+                for(std::size_t k = 0;k < 3;k++)
+                {
+                    const unsigned int a {corner[current[i + k]]},b {corner[current[i + (k + 1) % 3]]};
+                    edges.push_back((std::uint64_t(std::min(a,b)) << 32) | std::max(a,b));
+                }
+            }
+            std::sort(edges.begin(),edges.end());
+            std::vector<bool> border_corner(vertex_count,false);
+            for(std::size_t i = 0;i < edges.size();)
+            {
+                std::size_t j {i};
+                while(j < edges.size() && edges[j] == edges[i])
+                    ++j;
+                if(j - i == 1)
+                {
+                    border_corner[edges[i] >> 32] = true;
+                    border_corner[edges[i] & 0xFFFFFFFF] = true;
+                }
+                i = j;
+            }
+            for(std::size_t v = 0;v < vertex_count;v++)
+            {
+                if(border_corner[corner[v]])
+                    locked[v] = true;
+            }
+        }
+
+        const auto normal {[&](const std::array<double,3>& pa,unsigned int b,unsigned int c)
+        {
+            const auto& pb {positions[b]};
+            const auto& pc {positions[c]};
+            const std::array<double,3> u {pb[0] - pa[0],pb[1] - pa[1],pb[2] - pa[2]};
+            const std::array<double,3> w {pc[0] - pa[0],pc[1] - pa[1],pc[2] - pa[2]};
+            return std::array<double,3> {u[1] * w[2] - u[2] * w[1],u[2] * w[0] - u[0] * w[2],u[0] * w[1] - u[1] * w[0]};
+        }};
+
+        // every vertex starts with the planes of its triangles, weighted by area
+        std::vector<Quadric> quadrics(vertex_count);
+        for(std::size_t i = 0;i < current.size();i += 3)
+        {
+            const std::array<double,3> n {normal(positions[current[i]],current[i + 1],current[i + 2])};
+            const double len {std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2])};
+            if(len == 0.0)
+                continue;
+            const auto& p {positions[current[i]]};
+            const double a {n[0] / len},b {n[1] / len},c {n[2] / len};
+            const Quadric plane {Quadric::from_plane(a,b,c,-(a * p[0] + b * p[1] + c * p[2]),len * 0.5)};
+            for(std::size_t k = 0;k < 3;k++)
+                quadrics[current[i + k]] += plane;
+        }
+
+        const auto attribute_error {[&](unsigned int from,unsigned int to)
+        {
+            double sum {0.0};
+            for(std::size_t i = 0;i < vertex_len;i++)
+            {
+                if(i >= options.position_offset && i < options.position_offset + 3)
+                    continue;
+                const double d {double(vertices[from * vertex_len + i]) - vertices[to * vertex_len + i]};
+                sum += d * d;
+            }
+            return sum * options.attribute_weight;
+        }};
+
+        struct Collapse
+        {
+            unsigned int from;
+            unsigned int to;
+            double error;   // geometric, squared
+            double cost;
+        };
+        const double error_limit {target_error == std::numeric_limits<float>::max() ? std::numeric_limits<double>::max() : (target_error / extent) * (target_error / extent)};
+        double max_error {0.0};
+        std::vector<std::uint32_t> offsets(vertex_count + 1);
+        std::vector<std::uint32_t> adjacency;
+        std::vector<std::uint64_t> edges;
+        std::vector<Collapse> collapses;
+        std::vector<bool> touched(vertex_count);
+        std::vector<unsigned int> remap(vertex_count);
+
+        while(current.size() > target_index_count)
+        {
+            // triangles around each vertex
+            std::fill(offsets.begin(),offsets.end(),0);
+            for(const unsigned int v : current)
+                ++offsets[v + 1];
+            for(std::size_t v = 0;v < vertex_count;v++)
+                offsets[v + 1] += offsets[v];
+            adjacency.resize(current.size());
+            {
+                std::vector<std::uint32_t> cursor(offsets.begin(),offsets.end() - 1);
+                for(std::size_t i = 0;i < current.size();i++)
+                    adjacency[cursor[current[i]]++] = static_cast<std::uint32_t>(i / 3);
+            }
+
+            edges.clear();
+            for(std::size_t i = 0;i < current.size();i += 3)
+            {
+                for(std::size_t k = 0;k < 3;k++)
+                {
+                    const unsigned int a {current[i + k]},b {current[i + (k + 1) % 3]};
+                    edges.push_back((std::uint64_t(std::min(a,b)) << 32) | std::max(a,b));
+                }
+            }
+            std::sort(edges.begin(),edges.end());
+            edges.erase(std::unique(edges.begin(),edges.end()),edges.end());
+
+            collapses.clear();
+            for(const std::uint64_t edge : edges)
+            {
+                const unsigned int a {static_cast<unsigned int>(edge >> 32)},b {static_cast<unsigned int>(edge & 0xFFFFFFFF)};
+                Quadric both {quadrics[a]};
+                both += quadrics[b];
+                std::array<Collapse,2> options_of_edge {Collapse {a,b,both.error(positions[b]),0.0},Collapse {b,a,both.error(positions[a]),0.0}};
+                const Collapse* best {nullptr};
+                for(auto& collapse : options_of_edge)
+                {
+                    if(locked[collapse.from])
+                        continue;
+                    collapse.cost = collapse.error + attribute_error(collapse.from,collapse.to);
+                    if(best == nullptr || collapse.cost < best->cost)
+                        best = &collapse;
+                }
+                if(best != nullptr && best->error <= error_limit)
+                    collapses.push_back(*best);
+            }
+            std::sort(collapses.begin(),collapses.end(),[](const Collapse& x,const Collapse& y){return x.cost < y.cost;});
+
+            std::fill(touched.begin(),touched.end(),false);
+            for(std::size_t v = 0;v < vertex_count;v++)
+                remap[v] = static_cast<unsigned int>(v);
+            std::size_t triangle_count {current.size() / 3};
+            std::size_t applied {0};
+            for(const Collapse& collapse : collapses)
+            {
+                if(triangle_count * 3 <= target_index_count)
+                    break;
+                if(touched[collapse.from] || touched[collapse.to])
+                    continue;
+
+                // moving from onto to must not turn any of the remaining triangles around
+                bool flips {false};
+                std::size_t removed {0};
+                for(std::uint32_t i = offsets[collapse.from];i < offsets[collapse.from + 1] && !flips;i++)
+                {
+                    const unsigned int* t {&current[std::size_t(adjacency[i]) * 3]};
+                    if(t[0] == collapse.to || t[1] == collapse.to || t[2] == collapse.to)
+                    {
+                        ++removed;
+                        continue;
+                    }
+                    const std::size_t k {t[0] == collapse.from ? 0u : t[1] == collapse.from ? 1u : 2u};
+                    const unsigned int b {t[(k + 1) % 3]},c {t[(k + 2) % 3]};
+                    const std::array<double,3> before {normal(positions[collapse.from],b,c)};
+                    const std::array<double,3> after {normal(positions[collapse.to],b,c)};
+                    flips = before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0;
+                }
+                if(flips)
+                    continue;
+
+                remap[collapse.from] = collapse.to;
+                quadrics[collapse.to] += quadrics[collapse.from];
+                for(std::uint32_t i = offsets[collapse.from];i < offsets[collapse.from + 1];i++)
+                {
+                    const unsigned int* t {&current[std::size_t(adjacency[i]) * 3]};
+                    touched[t[0]] = touched[t[1]] = touched[t[2]] = true;
+                }
+                triangle_count -= std::min(removed,triangle_count);
+                max_error = std::max(max_error,collapse.error);
+                ++applied;
+            }
+            if(applied == 0)
+                break;
+
+            std::size_t write {0};
+            for(std::size_t i = 0;i < current.size();i += 3)
+            {
+                const unsigned int a {remap[current[i]]},b {remap[current[i + 1]]},c {remap[current[i + 2]]};
+                if(a == b || b == c || c == a)
+                    continue;
+                current[write++] = a;
+                current[write++] = b;
+                current[write++] = c;
+            }
+            current.resize(write);
+        }
+
+        level.error = static_cast<float>(std::sqrt(max_error) * extent);
+        return level;
+    }
+
+    /**
+     * @brief simplify a mesh into levels of detail over its vertex buffer, level 0 is the mesh itself
+     * @note  every level is simplified from the source mesh, on pool when there is one. a level that does not
+     *        remove enough triangles ends the chain
+     *
+     * @param indices
+     * @param vertices
+     * @param vertex_len
+     * @param level_count   at most, including level 0
+     * @param reduction     index count of a level against the level before it
+     * @param options
+     * @param pool
+     * @return std::vector<LodLevel> errors never decrease from a level to the next
+     */
+    inline std::vector<LodLevel> build_lod_chain(std::span<const unsigned int> indices,std::span<const float> vertices,std::size_t vertex_len,
+        std::size_t level_count = 4,float reduction = 0.5f,const SimplifyOptions& options = {},ThreadPool* pool = nullptr) noexcept(false)
+    {
+        std::vector<LodLevel> chain;
+        if(level_count == 0)
+            return chain;
+        chain.push_back(LodLevel {std::vector<unsigned int>(indices.begin(),indices.begin() + indices.size() / 3 * 3),0.0f});
+
+        std::vector<std::size_t> targets;
+        float target {static_cast<float>(chain.front().indices.size())};
+        for(std::size_t i = 1;i < level_count;i++)
+        {
+            target *= reduction;
+            targets.push_back(static_cast<std::size_t>(target) / 3 * 3);
+        }
+
+        std::vector<LodLevel> levels(targets.size());
+        if(pool != nullptr)
+        {
+            // the tasks read the data of the caller, so every one of them is waited for before leaving, exceptions included
+            std::vector<std::future<LodLevel>> futures;
+            futures.reserve(targets.size());
+            try
+            {
+                for(const std::size_t target_count : targets)
+                    futures.push_back(pool->submit([=](){return simplify(indices,vertices,vertex_len,target_count,std::numeric_limits<float>::max(),options);}));
+            }
+            catch(...)
+            {
+                wait_all(futures);
+                throw;
+            }
+            wait_all(futures);
+            for(std::size_t i = 0;i < futures.size();i++)
+                levels[i] = futures[i].get();
+        }
+        else
+        {
+            for(std::size_t i = 0;i < targets.size();i++)
+                levels[i] = simplify(indices,vertices,vertex_len,targets[i],std::numeric_limits<float>::max(),options);
+        }
+
+        for(auto& level : levels)
+        {
+            // stuck on locked vertices, a coarser target would give the same triangles
+            if(level.indices.size() >= chain.back().indices.size() * (1.0f + reduction) / 2.0f)
+                break;
+            level.error = std::max(level.error,chain.back().error);
+            chain.push_back(std::move(level));
+        }
+        return chain;
+    }
+
+    /**
+     * @brief the coarsest level whose error is within max_error, such as the world size of a pixel at the object distance
+     *
+     * @param chain
+     * @param max_error in mesh units
+     * @return std::size_t
+     */
+    inline std::size_t select_lod(std::span<const LodLevel> chain,float max_error) noexcept
+    {
+        std::size_t selected {0};
+        for(std::size_t i = 1;i < chain.size() && chain[i].error <= max_error;i++)
+            selected = i;
+        return selected;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,1230 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+namespace graphics
+{
+    /**
+     * @brief groups of OpenGL status a Scope can save and restore, combine them with operator|
+     *
+     */
+    enum class State : unsigned int
+    {
+        VertexArray     = 1 << 0,   // vertex array and its element buffer
+        ArrayBuffer     = 1 << 1,
+        Texture         = 1 << 2,
+        Framebuffer     = 1 << 3,   // draw and read framebuffer
+        Renderbuffer    = 1 << 4,
+        Program         = 1 << 5,
+        Viewport        = 1 << 6,
+        Depth           = 1 << 7,   // depth test, func, write mask and range
+        Stencil         = 1 << 8,   // stencil test, front and back func, op, masks and clear value
+        Blend           = 1 << 9,   // blend test, factors and blend color
+        Raster          = 1 << 10,  // cull face test, mode and front face, polygon mode, point size, line width and scissor test
+        Restart         = 1 << 11,  // primitive restart test and index
+        Bindings        = VertexArray | ArrayBuffer | Texture | Framebuffer | Renderbuffer | Program,
+        All             = Bindings | Viewport | Depth | Stencil | Blend | Raster | Restart
+    };
+
+    constexpr State operator|(State a,State b) noexcept
+    {
+        return static_cast<State>(static_cast<unsigned int>(a) | static_cast<unsigned int>(b));
+    }
+
+    constexpr State operator&(State a,State b) noexcept
+    {
+        return static_cast<State>(static_cast<unsigned int>(a) & static_cast<unsigned int>(b));
+    }
+
+    /**
+     * @brief check if any group of want is in states
+     *
+     * @param states
+     * @param want
+     * @return true
+     * @return false
+     */
+    constexpr bool has_state(State states,State want) noexcept
+    {
+        return static_cast<unsigned int>(states & want) != 0;
+    }
+
+    /**
+     * @brief single pieces of OpenGL status, each one is restored by one group of OpenGL calls
+     *
+     */
+    enum class Field : unsigned int
+    {
+        VertexArray,ElementBuffer,ArrayBuffer,Texture,Framebuffer,Renderbuffer,Program,
+        Viewport,DepthTest,DepthFunc,DepthMask,DepthRange,
+        StencilTest,StencilFunc,StencilMask,StencilOp,StencilClear,
+        BlendTest,BlendFunc,BlendColor,CullFaceTest,CullFace,FrontFace,PolygonMode,ScissorTest,PointSize,LineWidth,
+        PrimitiveRestart,PrimitiveRestartIndex
+    };
+
+    constexpr unsigned int field_count {static_cast<unsigned int>(Field::PrimitiveRestartIndex) + 1};
+
+    /**
+     * @brief name of a field for reports
+     *
+     * @param field
+     * @return std::string_view
+     */
+    constexpr std::string_view field_name(Field field) noexcept
+    {
+        constexpr std::array<std::string_view,field_count> names
+        {
+            "vertex_array","element_buffer","array_buffer","texture","framebuffer","renderbuffer","program",
+            "viewport","depth_test","depth_func","depth_mask","depth_range",
+            "stencil_test","stencil_func","stencil_mask","stencil_op","stencil_clear",
+            "blend_test","blend_func","blend_color","cull_face_test","cull_face","front_face","polygon_mode","scissor_test","point_size","line_width",
+            "primitive_restart","primitive_restart_index"
+        };
+        return names[static_cast<unsigned int>(field)];
+    }
+
+    using FieldMask = std::uint32_t;
+
+    constexpr FieldMask field_bit(Field field) noexcept
+    {
+        return FieldMask(1) << static_cast<unsigned int>(field);
+    }
+
+    template <Field... fields>
+    constexpr FieldMask field_bits() noexcept
+    {
+        return (field_bit(fields) | ...);
+    }
+
+    /**
+     * @brief all the fields in some groups of status
+     *
+     * @param states
+     * @return FieldMask
+     */
+    constexpr FieldMask fields_of(State states) noexcept
+    {
+        FieldMask mask {0};
+        if(has_state(states,State::VertexArray))
+            mask |= field_bits<Field::VertexArray,Field::ElementBuffer>();
+        if(has_state(states,State::ArrayBuffer))
+            mask |= field_bit(Field::ArrayBuffer);
+        if(has_state(states,State::Texture))
+            mask |= field_bit(Field::Texture);
+        if(has_state(states,State::Framebuffer))
+            mask |= field_bit(Field::Framebuffer);
+        if(has_state(states,State::Renderbuffer))
+            mask |= field_bit(Field::Renderbuffer);
+        if(has_state(states,State::Program))
+            mask |= field_bit(Field::Program);
+        if(has_state(states,State::Viewport))
+            mask |= field_bit(Field::Viewport);
+        if(has_state(states,State::Depth))
+            mask |= field_bits<Field::DepthTest,Field::DepthFunc,Field::DepthMask,Field::DepthRange>();
+        if(has_state(states,State::Stencil))
+            mask |= field_bits<Field::StencilTest,Field::StencilFunc,Field::StencilMask,Field::StencilOp,Field::StencilClear>();
+        if(has_state(states,State::Blend))
+            mask |= field_bits<Field::BlendTest,Field::BlendFunc,Field::BlendColor>();
+        if(has_state(states,State::Raster))
+            mask |= field_bits<Field::CullFaceTest,Field::CullFace,Field::FrontFace,Field::PolygonMode,Field::ScissorTest,Field::PointSize,Field::LineWidth>();
+        if(has_state(states,State::Restart))
+            mask |= field_bits<Field::PrimitiveRestart,Field::PrimitiveRestartIndex>();
+        return mask;
+    }
+
+    /**
+     * @brief the OpenGL status glbind saves and restores around a Scope
+     *
+     */
+    struct StatusRecord
+    {
+        int vao_id;
+        int vbo_id;
+        int ebo_id;
+        int texture_2d_id;
+        int draw_framebuffer_id;
+        int read_framebuffer_id;
+        int renderbuffer_id;
+        int program_id;
+        int cullface_mode;
+        int front_face;
+        int polygon_mode_front;
+        int polygon_mode_back;
+        int depth_func;
+        int stencil_func;
+        int stencil_ref;
+        int stencil_value_mask;
+        int stencil_write_mask;
+        int stencil_fail_op;
+        int stencil_depth_fail_op;
+        int stencil_pass_op;
+        int stencil_back_func;
+        int stencil_back_ref;
+        int stencil_back_value_mask;
+        int stencil_back_write_mask;
+        int stencil_back_fail_op;
+        int stencil_back_depth_fail_op;
+        int stencil_back_pass_op;
+        int stencil_clear_value;
+        int blend_src_rgb;
+        int blend_dst_rgb;
+        int blend_src_alpha;
+        int blend_dst_alpha;
+        int primitive_restart_index;
+        bool stencil_test;
+        bool depth_test;
+        bool depth_writemask;
+        bool blend_test;
+        bool cullface_test;
+        bool scissor_test;
+        bool primitive_restart;
+        float point_size;
+        float line_width;
+        std::array<int,4> viewport;
+        std::array<float,2> depth_range;
+        std::array<float,4> blend_color;
+    };
+
+    /**
+     * @brief CPU side shadow copy of the OpenGL status
+     * @warning the driver is only queried once (or after invalidate()), every later change must go
+     *          through glbind, call sync() after changing the status with raw OpenGL calls
+     */
+    class StatusCache
+    {
+    public:
+        /**
+         * @brief how deep Scopes can be nested
+         *
+         */
+        static constexpr std::size_t max_scope_depth {32};
+
+    private:
+        /**
+         * @brief the fields a Scope changed and their values before the first change
+         *
+         */
+        struct ScopeFrame
+        {
+            FieldMask saved_fields;
+            StatusRecord saved;
+        };
+
+        StatusRecord record;
+        bool synced {false};
+        std::array<ScopeFrame,max_scope_depth> frames;
+        std::size_t depth {0};
+        std::size_t skipped_bind_count {0};
+        std::size_t skipped_state_count {0};
+
+        /**
+         * @brief the pipeline state object that last set each field, nullptr once anything else changed it
+         *
+         */
+        std::array<const void*,field_count> field_owners {};
+
+        /**
+         * @brief element buffer binding of each vertex array (it is a vertex array status in OpenGL)
+         *
+         */
+        std::unordered_map<int,int> vao_ebo_ids;
+
+        /**
+         * @brief get the element buffer bound to the current vertex array, query OpenGL only if unknown
+         *
+         * @return int
+         */
+        int resolve_ebo_id() noexcept
+        {
+            auto it {vao_ebo_ids.find(record.vao_id)};
+            if(it == vao_ebo_ids.end())
+            {
+                int ebo_id;
+                glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING,&ebo_id);
+                it = vao_ebo_ids.emplace(record.vao_id,ebo_id).first;
+            }
+            return it->second;
+        }
+
+        void ensure_synced() noexcept
+        {
+            if(!synced)
+                sync();
+        }
+
+        static void set_capability(GLenum cap,bool enable) noexcept
+        {
+            enable ? glEnable(cap) : glDisable(cap);
+        }
+
+        /**
+         * @brief copy the members of a field from src to dst
+         *
+         * @param field
+         * @param dst
+         * @param src
+         */
+        static void copy_field(Field field,StatusRecord& dst,const StatusRecord& src) noexcept
+        {
+            switch(field)
+            {
+            case Field::VertexArray:
+                dst.vao_id = src.vao_id;
+                break;
+            case Field::ElementBuffer:
+                dst.ebo_id = src.ebo_id;
+                break;
+            case Field::ArrayBuffer:
+                dst.vbo_id = src.vbo_id;
+                break;
+            case Field::Texture:
+                dst.texture_2d_id = src.texture_2d_id;
+                break;
+            case Field::Framebuffer:
+                dst.draw_framebuffer_id = src.draw_framebuffer_id;
+                dst.read_framebuffer_id = src.read_framebuffer_id;
+                break;
+            case Field::Renderbuffer:
+                dst.renderbuffer_id = src.renderbuffer_id;
+                break;
+            case Field::Program:
+                dst.program_id = src.program_id;
+                break;
+            case Field::Viewport:
+                dst.viewport = src.viewport;
+                break;
+            case Field::DepthTest:
+                dst.depth_test = src.depth_test;
+                break;
+            case Field::DepthFunc:
+                dst.depth_func = src.depth_func;
+                break;
+            case Field::DepthMask:
+                dst.depth_writemask = src.depth_writemask;
+                break;
+            case Field::DepthRange:
+                dst.depth_range = src.depth_range;
+                break;
+            case Field::StencilTest:
+                dst.stencil_test = src.stencil_test;
+                break;
+            case Field::StencilFunc:
+                dst.stencil_func = src.stencil_func;
+                dst.stencil_ref = src.stencil_ref;
+                dst.stencil_value_mask = src.stencil_value_mask;
+                dst.stencil_back_func = src.stencil_back_func;
+                dst.stencil_back_ref = src.stencil_back_ref;
+                dst.stencil_back_value_mask = src.stencil_back_value_mask;
+                break;
+            case Field::StencilMask:
+                dst.stencil_write_mask = src.stencil_write_mask;
+                dst.stencil_back_write_mask = src.stencil_back_write_mask;
+                break;
+            case Field::StencilOp:
+                dst.stencil_fail_op = src.stencil_fail_op;
+                dst.stencil_depth_fail_op = src.stencil_depth_fail_op;
+                dst.stencil_pass_op = src.stencil_pass_op;
+                dst.stencil_back_fail_op = src.stencil_back_fail_op;
+                dst.stencil_back_depth_fail_op = src.stencil_back_depth_fail_op;
+                dst.stencil_back_pass_op = src.stencil_back_pass_op;
+                break;
+            case Field::StencilClear:
+                dst.stencil_clear_value = src.stencil_clear_value;
+                break;
+            case Field::BlendTest:
+                dst.blend_test = src.blend_test;
+                break;
+            case Field::BlendFunc:
+                dst.blend_src_rgb = src.blend_src_rgb;
+                dst.blend_dst_rgb = src.blend_dst_rgb;
+                dst.blend_src_alpha = src.blend_src_alpha;
+                dst.blend_dst_alpha = src.blend_dst_alpha;
+                break;
+            case Field::BlendColor:
+                dst.blend_color = src.blend_color;
+                break;
+            case Field::CullFaceTest:
+                dst.cullface_test = src.cullface_test;
+                break;
+            case Field::CullFace:
+                dst.cullface_mode = src.cullface_mode;
+                break;
+            case Field::FrontFace:
+                dst.front_face = src.front_face;
+                break;
+            case Field::PolygonMode:
+                dst.polygon_mode_front = src.polygon_mode_front;
+                dst.polygon_mode_back = src.polygon_mode_back;
+                break;
+            case Field::ScissorTest:
+                dst.scissor_test = src.scissor_test;
+                break;
+            case Field::PointSize:
+                dst.point_size = src.point_size;
+                break;
+            case Field::LineWidth:
+                dst.line_width = src.line_width;
+                break;
+            case Field::PrimitiveRestart:
+                dst.primitive_restart = src.primitive_restart;
+                break;
+            case Field::PrimitiveRestartIndex:
+                dst.primitive_restart_index = src.primitive_restart_index;
+                break;
+            }
+        }
+
+        /**
+         * @brief copy a field from src into a frame unless the frame already holds an older value of it
+         * @note  the saved ebo always belongs to the vertex array bound when the frame began
+         *
+         * @param frame
+         * @param field
+         * @param src
+         */
+        static void save_field(ScopeFrame& frame,Field field,const StatusRecord& src) noexcept
+        {
+            if(frame.saved_fields & field_bit(field))
+                return;
+
+            if(field == Field::VertexArray && !(frame.saved_fields & field_bit(Field::ElementBuffer)))
+                copy_field(Field::ElementBuffer,frame.saved,src);
+            if(field != Field::ElementBuffer || !(frame.saved_fields & field_bit(Field::VertexArray)))
+                copy_field(field,frame.saved,src);
+            frame.saved_fields |= field_bit(field);
+        }
+
+        /**
+         * @brief write a saved field back to OpenGL (vertex array and element buffer excluded)
+         * @note  nothing is issued when the field already holds the saved value
+         *
+         * @param field
+         * @param saved
+         */
+        void apply_field(Field field,const StatusRecord& saved) noexcept
+        {
+            if(same_field(field,record,saved))
+            {
+                if(field <= Field::Program)
+                    ++skipped_bind_count;
+                else
+                    ++skipped_state_count;
+                return;
+            }
+
+            switch(field)
+            {
+            case Field::VertexArray:
+            case Field::ElementBuffer:
+                break;
+            case Field::ArrayBuffer:
+                glBindBuffer(GL_ARRAY_BUFFER, saved.vbo_id);
+                break;
+            case Field::Texture:
+                glBindTexture(GL_TEXTURE_2D, saved.texture_2d_id);
+                break;
+            case Field::Framebuffer:
+                if(saved.draw_framebuffer_id == saved.read_framebuffer_id)
+                    glBindFramebuffer(GL_FRAMEBUFFER, saved.draw_framebuffer_id);
+                else
+                {
+                    if(record.draw_framebuffer_id != saved.draw_framebuffer_id)
+                        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, saved.draw_framebuffer_id);
+                    if(record.read_framebuffer_id != saved.read_framebuffer_id)
+                        glBindFramebuffer(GL_READ_FRAMEBUFFER, saved.read_framebuffer_id);
+                }
+                break;
+            case Field::Renderbuffer:
+                glBindRenderbuffer(GL_RENDERBUFFER, saved.renderbuffer_id);
+                break;
+            case Field::Program:
+                glUseProgram(saved.program_id);
+                break;
+            case Field::Viewport:
+                glViewport(saved.viewport[0], saved.viewport[1], saved.viewport[2], saved.viewport[3]);
+                break;
+            case Field::DepthTest:
+                set_capability(GL_DEPTH_TEST,saved.depth_test);
+                break;
+            case Field::DepthFunc:
+                glDepthFunc(saved.depth_func);
+                break;
+            case Field::DepthMask:
+                glDepthMask(saved.depth_writemask);
+                break;
+            case Field::DepthRange:
+                glDepthRange(saved.depth_range[0], saved.depth_range[1]);
+                break;
+            case Field::StencilTest:
+                set_capability(GL_STENCIL_TEST,saved.stencil_test);
+                break;
+            case Field::StencilFunc:
+                glStencilFuncSeparate(GL_FRONT, saved.stencil_func, saved.stencil_ref, saved.stencil_value_mask);
+                glStencilFuncSeparate(GL_BACK, saved.stencil_back_func, saved.stencil_back_ref, saved.stencil_back_value_mask);
+                break;
+            case Field::StencilMask:
+                glStencilMaskSeparate(GL_FRONT, saved.stencil_write_mask);
+                glStencilMaskSeparate(GL_BACK, saved.stencil_back_write_mask);
+                break;
+            case Field::StencilOp:
+                glStencilOpSeparate(GL_FRONT, saved.stencil_fail_op, saved.stencil_depth_fail_op, saved.stencil_pass_op);
+                glStencilOpSeparate(GL_BACK, saved.stencil_back_fail_op, saved.stencil_back_depth_fail_op, saved.stencil_back_pass_op);
+                break;
+            case Field::StencilClear:
+                glClearStencil(saved.stencil_clear_value);
+                break;
+            case Field::BlendTest:
+                set_capability(GL_BLEND,saved.blend_test);
+                break;
+            case Field::BlendFunc:
+                glBlendFuncSeparate(saved.blend_src_rgb, saved.blend_dst_rgb, saved.blend_src_alpha, saved.blend_dst_alpha);
+                break;
+            case Field::BlendColor:
+                glBlendColor(saved.blend_color[0], saved.blend_color[1], saved.blend_color[2], saved.blend_color[3]);
+                break;
+            case Field::CullFaceTest:
+                set_capability(GL_CULL_FACE,saved.cullface_test);
+                break;
+            case Field::CullFace:
+                glCullFace(saved.cullface_mode);
+                break;
+            case Field::FrontFace:
+                glFrontFace(saved.front_face);
+                break;
+            case Field::PolygonMode:
+                // the core profile only takes GL_FRONT_AND_BACK, a split is only ever recorded on a compatibility context
+                if(saved.polygon_mode_front == saved.polygon_mode_back)
+                    glPolygonMode(GL_FRONT_AND_BACK, saved.polygon_mode_front);
+                else
+                {
+                    glPolygonMode(GL_FRONT, saved.polygon_mode_front);
+                    glPolygonMode(GL_BACK, saved.polygon_mode_back);
+                }
+                break;
+            case Field::ScissorTest:
+                set_capability(GL_SCISSOR_TEST,saved.scissor_test);
+                break;
+            case Field::PointSize:
+                glPointSize(saved.point_size);
+                break;
+            case Field::LineWidth:
+                glLineWidth(saved.line_width);
+                break;
+            case Field::PrimitiveRestart:
+                set_capability(GL_PRIMITIVE_RESTART,saved.primitive_restart);
+                break;
+            case Field::PrimitiveRestartIndex:
+                glPrimitiveRestartIndex(static_cast<unsigned int>(saved.primitive_restart_index));
+                break;
+            }
+
+            field_owners[static_cast<unsigned int>(field)] = nullptr;
+            copy_field(field,record,saved);
+        }
+
+        /**
+         * @brief count a bind that is skipped because the object is already bound
+         *
+         * @param already_bound
+         * @return true     the bind can be skipped
+         * @return false
+         */
+        bool skip_bind(bool already_bound) noexcept
+        {
+            if(already_bound)
+                ++skipped_bind_count;
+            return already_bound;
+        }
+
+        /**
+         * @brief count a state change that is skipped because OpenGL already holds the value
+         *
+         * @param unchanged
+         * @return true     the change can be skipped
+         * @return false
+         */
+        bool skip_state(bool unchanged) noexcept
+        {
+            if(unchanged)
+                ++skipped_state_count;
+            return unchanged;
+        }
+
+        /**
+         * @brief remember the value of a field before glbind changes it inside a Scope
+         *
+         * @param field
+         */
+        void touch(Field field) noexcept
+        {
+            field_owners[static_cast<unsigned int>(field)] = nullptr;
+            if(depth == 0)
+                return;
+            if(field == Field::VertexArray || field == Field::ElementBuffer)
+                record.ebo_id = resolve_ebo_id();
+            save_field(frames[depth - 1],field,record);
+        }
+
+    public:
+        StatusCache() noexcept = default;
+        StatusCache(StatusCache&) = delete;
+        ~StatusCache() noexcept = default;
+
+        /**
+         * @brief whether a field holds the same value in a and b
+         *
+         * @param field
+         * @param a
+         * @param b
+         * @return true
+         * @return false
+         */
+        static bool same_field(Field field,const StatusRecord& a,const StatusRecord& b) noexcept
+        {
+            switch(field)
+            {
+            case Field::VertexArray:
+                return a.vao_id == b.vao_id;
+            case Field::ElementBuffer:
+                return a.ebo_id == b.ebo_id;
+            case Field::ArrayBuffer:
+                return a.vbo_id == b.vbo_id;
+            case Field::Texture:
+                return a.texture_2d_id == b.texture_2d_id;
+            case Field::Framebuffer:
+                return a.draw_framebuffer_id == b.draw_framebuffer_id && a.read_framebuffer_id == b.read_framebuffer_id;
+            case Field::Renderbuffer:
+                return a.renderbuffer_id == b.renderbuffer_id;
+            case Field::Program:
+                return a.program_id == b.program_id;
+            case Field::Viewport:
+                return a.viewport == b.viewport;
+            case Field::DepthTest:
+                return a.depth_test == b.depth_test;
+            case Field::DepthFunc:
+                return a.depth_func == b.depth_func;
+            case Field::DepthMask:
+                return a.depth_writemask == b.depth_writemask;
+            case Field::DepthRange:
+                return a.depth_range == b.depth_range;
+            case Field::StencilTest:
+                return a.stencil_test == b.stencil_test;
+            case Field::StencilFunc:
+                return a.stencil_func == b.stencil_func && a.stencil_ref == b.stencil_ref && a.stencil_value_mask == b.stencil_value_mask
+                    && a.stencil_back_func == b.stencil_back_func && a.stencil_back_ref == b.stencil_back_ref && a.stencil_back_value_mask == b.stencil_back_value_mask;
+            case Field::StencilMask:
+                return a.stencil_write_mask == b.stencil_write_mask && a.stencil_back_write_mask == b.stencil_back_write_mask;
+            case Field::StencilOp:
+                return a.stencil_fail_op == b.stencil_fail_op && a.stencil_depth_fail_op == b.stencil_depth_fail_op && a.stencil_pass_op == b.stencil_pass_op
+                    && a.stencil_back_fail_op == b.stencil_back_fail_op && a.stencil_back_depth_fail_op == b.stencil_back_depth_fail_op && a.stencil_back_pass_op == b.stencil_back_pass_op;
+            case Field::StencilClear:
+                return a.stencil_clear_value == b.stencil_clear_value;
+            case Field::BlendTest:
+                return a.blend_test == b.blend_test;
+            case Field::BlendFunc:
+                return a.blend_src_rgb == b.blend_src_rgb && a.blend_dst_rgb == b.blend_dst_rgb
+                    && a.blend_src_alpha == b.blend_src_alpha && a.blend_dst_alpha == b.blend_dst_alpha;
+            case Field::BlendColor:
+                return a.blend_color == b.blend_color;
+            case Field::CullFaceTest:
+                return a.cullface_test == b.cullface_test;
+            case Field::CullFace:
+                return a.cullface_mode == b.cullface_mode;
+            case Field::FrontFace:
+                return a.front_face == b.front_face;
+            case Field::PolygonMode:
+                return a.polygon_mode_front == b.polygon_mode_front && a.polygon_mode_back == b.polygon_mode_back;
+            case Field::ScissorTest:
+                return a.scissor_test == b.scissor_test;
+            case Field::PointSize:
+                return a.point_size == b.point_size;
+            case Field::LineWidth:
+                return a.line_width == b.line_width;
+            case Field::PrimitiveRestart:
+                return a.primitive_restart == b.primitive_restart;
+            case Field::PrimitiveRestartIndex:
+                return a.primitive_restart_index == b.primitive_restart_index;
+            }
+            return false;
+        }
+
+        /**
+         * @brief read the whole status straight from OpenGL, the cache is left as it is
+         *
+         * @param status
+         */
+        static void query(StatusRecord& status) noexcept
+        {
+            int polygon_mode[2];
+            glGetIntegerv(GL_POLYGON_MODE, polygon_mode);
+            status.polygon_mode_front = polygon_mode[0];
+            status.polygon_mode_back = polygon_mode[1];
+
+            glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &status.vao_id);
+            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &status.vbo_id);
+            glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &status.ebo_id);
+            glGetIntegerv(GL_TEXTURE_BINDING_2D,&status.texture_2d_id);
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING,&status.draw_framebuffer_id);
+            glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING,&status.read_framebuffer_id);
+            glGetIntegerv(GL_RENDERBUFFER_BINDING,&status.renderbuffer_id);
+            glGetIntegerv(GL_CURRENT_PROGRAM,&status.program_id);
+            glGetIntegerv(GL_VIEWPORT,status.viewport.data());
+            glGetIntegerv(GL_STENCIL_FUNC,&status.stencil_func);
+            glGetIntegerv(GL_STENCIL_REF,&status.stencil_ref);
+            glGetIntegerv(GL_STENCIL_VALUE_MASK,&status.stencil_value_mask);
+            glGetIntegerv(GL_STENCIL_WRITEMASK,&status.stencil_write_mask);
+            glGetIntegerv(GL_STENCIL_FAIL,&status.stencil_fail_op);
+            glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL,&status.stencil_depth_fail_op);
+            glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS,&status.stencil_pass_op);
+            glGetIntegerv(GL_CULL_FACE_MODE,&status.cullface_mode);
+            glGetIntegerv(GL_FRONT_FACE,&status.front_face);
+            glGetBooleanv(GL_CULL_FACE,reinterpret_cast<GLboolean*>(&status.cullface_test));
+            glGetBooleanv(GL_DEPTH_TEST,reinterpret_cast<GLboolean*>(&status.depth_test));
+            glGetBooleanv(GL_STENCIL_TEST,reinterpret_cast<GLboolean*>(&status.stencil_test));
+            glGetBooleanv(GL_BLEND,reinterpret_cast<GLboolean*>(&status.blend_test));
+            glGetBooleanv(GL_SCISSOR_TEST,reinterpret_cast<GLboolean*>(&status.scissor_test));
+            glGetFloatv(GL_POINT_SIZE,&status.point_size);
+            glGetFloatv(GL_LINE_WIDTH,&status.line_width);
+            glGetBooleanv(GL_PRIMITIVE_RESTART,reinterpret_cast<GLboolean*>(&status.primitive_restart));
+            glGetIntegerv(GL_PRIMITIVE_RESTART_INDEX,&status.primitive_restart_index);
+            glGetIntegerv(GL_DEPTH_FUNC, &status.depth_func);
+            glGetFloatv(GL_DEPTH_RANGE, status.depth_range.data());
+            glGetBooleanv(GL_DEPTH_WRITEMASK,reinterpret_cast<GLboolean*>(&status.depth_writemask));
+            glGetIntegerv(GL_STENCIL_BACK_FUNC, &status.stencil_back_func);
+            glGetIntegerv(GL_STENCIL_BACK_REF, &status.stencil_back_ref);
+            glGetIntegerv(GL_STENCIL_BACK_VALUE_MASK, &status.stencil_back_value_mask);
+            glGetIntegerv(GL_STENCIL_BACK_WRITEMASK, &status.stencil_back_write_mask);
+            glGetIntegerv(GL_STENCIL_BACK_FAIL, &status.stencil_back_fail_op);
+            glGetIntegerv(GL_STENCIL_BACK_PASS_DEPTH_FAIL, &status.stencil_back_depth_fail_op);
+            glGetIntegerv(GL_STENCIL_BACK_PASS_DEPTH_PASS, &status.stencil_back_pass_op);
+            glGetIntegerv(GL_STENCIL_CLEAR_VALUE, &status.stencil_clear_value);
+            glGetFloatv(GL_BLEND_COLOR, status.blend_color.data());
+            glGetIntegerv(GL_BLEND_SRC_RGB, &status.blend_src_rgb);
+            glGetIntegerv(GL_BLEND_DST_RGB, &status.blend_dst_rgb);
+            glGetIntegerv(GL_BLEND_SRC_ALPHA, &status.blend_src_alpha);
+            glGetIntegerv(GL_BLEND_DST_ALPHA, &status.blend_dst_alpha);
+        }
+
+        /**
+         * @brief query the whole status from OpenGL
+         *
+         */
+        void sync() noexcept
+        {
+            // the status glbind believed in is what the current Scope has to restore
+            if(synced)
+            {
+                for(unsigned int i = 0;i < field_count;i++)
+                    touch(static_cast<Field>(i));
+            }
+
+            vao_ebo_ids.clear();
+            field_owners.fill(nullptr);
+
+            query(record);
+
+            vao_ebo_ids.emplace(record.vao_id,record.ebo_id);
+            synced = true;
+        }
+
+        /**
+         * @brief drop the shadow copy, the next get() will query OpenGL again
+         *
+         */
+        void invalidate() noexcept
+        {
+            synced = false;
+            field_owners.fill(nullptr);
+        }
+
+        /**
+         * @brief get the current status without touching the driver (except for the first call)
+         *
+         * @return const StatusRecord&
+         */
+        const StatusRecord& get() noexcept
+        {
+            ensure_synced();
+            record.ebo_id = resolve_ebo_id();
+            return record;
+        }
+
+        /**
+         * @brief start recording the changes of a new (nested) Scope
+         * @warning throw std::runtime_error when Scopes are nested deeper than max_scope_depth
+         *
+         */
+        void begin_scope() noexcept(false)
+        {
+            if(depth == max_scope_depth)
+                throw std::runtime_error("glbind Scope nested too deep");
+            ensure_synced();
+            frames[depth++].saved_fields = 0;
+        }
+
+        /**
+         * @brief write the fields changed since begin_scope() back to OpenGL
+         * @note  changes outside the restored groups are handed over to the outer Scope
+         *
+         * @tparam states the groups to restore, others are left as they are
+         */
+        template <State states = State::All>
+        void end_scope() noexcept
+        {
+            constexpr FieldMask restorable {fields_of(states)};
+            constexpr FieldMask vertex_array_fields {field_bits<Field::VertexArray,Field::ElementBuffer>()};
+            const ScopeFrame& frame {frames[--depth]};
+
+            if(frame.saved_fields & restorable & vertex_array_fields)
+            {
+                if(frame.saved_fields & field_bit(Field::VertexArray) && !skip_bind(record.vao_id == frame.saved.vao_id))
+                {
+                    glBindVertexArray(frame.saved.vao_id);
+                    record.vao_id = frame.saved.vao_id;
+                }
+                if(!skip_bind(resolve_ebo_id() == frame.saved.ebo_id))
+                {
+                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, frame.saved.ebo_id);
+                    vao_ebo_ids[record.vao_id] = frame.saved.ebo_id;
+                }
+            }
+
+            for(FieldMask changed {frame.saved_fields & restorable & ~vertex_array_fields};changed != 0;changed &= changed - 1)
+                apply_field(static_cast<Field>(std::countr_zero(changed)),frame.saved);
+
+            if(depth > 0)
+            {
+                for(FieldMask left {frame.saved_fields & ~restorable};left != 0;left &= left - 1)
+                    save_field(frames[depth - 1],static_cast<Field>(std::countr_zero(left)),frame.saved);
+            }
+        }
+
+        /**
+         * @brief how many binds were skipped because the object was already bound
+         *
+         * @return std::size_t
+         */
+        std::size_t get_skipped_bind_count() const noexcept
+        {
+            return skipped_bind_count;
+        }
+
+        void reset_skipped_bind_count() noexcept
+        {
+            skipped_bind_count = 0;
+        }
+
+        /**
+         * @brief how many state changes were skipped because OpenGL already held the value
+         *
+         * @return std::size_t
+         */
+        std::size_t get_skipped_state_count() const noexcept
+        {
+            return skipped_state_count;
+        }
+
+        void reset_skipped_state_count() noexcept
+        {
+            skipped_state_count = 0;
+        }
+
+        /**
+         * @brief check if every field in fields is still the one set by owner
+         *
+         * @param owner     the pipeline state object
+         * @param fields
+         * @return true     nothing changed those fields since mark_applied(owner,fields)
+         * @return false
+         */
+        bool is_applied(const void* owner,FieldMask fields) const noexcept
+        {
+            for(;fields != 0;fields &= fields - 1)
+            {
+                if(field_owners[std::countr_zero(fields)] != owner)
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief record that owner has just set the fields, any later change through glbind drops it
+         *
+         * @param owner     the pipeline state object
+         * @param fields
+         */
+        void mark_applied(const void* owner,FieldMask fields) noexcept
+        {
+            for(;fields != 0;fields &= fields - 1)
+                field_owners[std::countr_zero(fields)] = owner;
+        }
+
+        void bind_vertex_array(unsigned int vao_id) noexcept
+        {
+            ensure_synced();
+            if(skip_bind(record.vao_id == static_cast<int>(vao_id)))
+                return;
+            touch(Field::VertexArray);
+            glBindVertexArray(vao_id);
+            record.vao_id = vao_id;
+        }
+
+        /**
+         * @brief bind a buffer to GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+         *
+         * @param target
+         * @param buffer_id
+         */
+        void bind_buffer(GLenum target,unsigned int buffer_id) noexcept
+        {
+            ensure_synced();
+            if(target == GL_ARRAY_BUFFER)
+            {
+                if(skip_bind(record.vbo_id == static_cast<int>(buffer_id)))
+                    return;
+                touch(Field::ArrayBuffer);
+                record.vbo_id = buffer_id;
+            }
+            else if(target == GL_ELEMENT_ARRAY_BUFFER)
+            {
+                if(skip_bind(resolve_ebo_id() == static_cast<int>(buffer_id)))
+                    return;
+                touch(Field::ElementBuffer);
+                vao_ebo_ids[record.vao_id] = buffer_id;
+            }
+            glBindBuffer(target,buffer_id);
+        }
+
+        void bind_texture_2d(unsigned int texture_id) noexcept
+        {
+            ensure_synced();
+            if(skip_bind(record.texture_2d_id == static_cast<int>(texture_id)))
+                return;
+            touch(Field::Texture);
+            glBindTexture(GL_TEXTURE_2D,texture_id);
+            record.texture_2d_id = texture_id;
+        }
+
+        /**
+         * @brief bind a framebuffer to GL_FRAMEBUFFER, GL_DRAW_FRAMEBUFFER or GL_READ_FRAMEBUFFER
+         *
+         * @param target
+         * @param fbo_id
+         */
+        void bind_framebuffer(GLenum target,unsigned int fbo_id) noexcept
+        {
+            ensure_synced();
+            const bool draw_bound {target == GL_READ_FRAMEBUFFER || record.draw_framebuffer_id == static_cast<int>(fbo_id)};
+            const bool read_bound {target == GL_DRAW_FRAMEBUFFER || record.read_framebuffer_id == static_cast<int>(fbo_id)};
+            if(skip_bind(draw_bound && read_bound))
+                return;
+            touch(Field::Framebuffer);
+            glBindFramebuffer(target,fbo_id);
+            if(target != GL_READ_FRAMEBUFFER)
+                record.draw_framebuffer_id = fbo_id;
+            if(target != GL_DRAW_FRAMEBUFFER)
+                record.read_framebuffer_id = fbo_id;
+        }
+
+        void bind_renderbuffer(unsigned int rbo_id) noexcept
+        {
+            ensure_synced();
+            if(skip_bind(record.renderbuffer_id == static_cast<int>(rbo_id)))
+                return;
+            touch(Field::Renderbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER,rbo_id);
+            record.renderbuffer_id = rbo_id;
+        }
+
+        void use_program(unsigned int program_id) noexcept
+        {
+            ensure_synced();
+            if(skip_bind(record.program_id == static_cast<int>(program_id)))
+                return;
+            touch(Field::Program);
+            glUseProgram(program_id);
+            record.program_id = program_id;
+        }
+
+        void set_viewport(int x,int y,int w,int h) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.viewport == std::array<int,4>{x,y,w,h}))
+                return;
+            touch(Field::Viewport);
+            glViewport(x,y,w,h);
+            record.viewport = {x,y,w,h};
+        }
+
+        /**
+         * @brief set the polygon mode of one face or both
+         * @note  the core profile rejects GL_FRONT and GL_BACK. a change leaving both faces equal is sent as GL_FRONT_AND_BACK,
+         *        a real split is sent as asked and the cache records what OpenGL then reports, so it never believes in a split core refused
+         *
+         * @param face  GL_FRONT, GL_BACK or GL_FRONT_AND_BACK
+         * @param mode
+         */
+        void set_polygon_mode(GLenum face,int mode) noexcept
+        {
+            ensure_synced();
+            const int front {face == GL_BACK ? record.polygon_mode_front : mode};
+            const int back {face == GL_FRONT ? record.polygon_mode_back : mode};
+            if(skip_state(record.polygon_mode_front == front && record.polygon_mode_back == back))
+                return;
+            touch(Field::PolygonMode);
+            if(front == back)
+            {
+                glPolygonMode(GL_FRONT_AND_BACK,mode);
+                record.polygon_mode_front = record.polygon_mode_back = mode;
+                return;
+            }
+
+            glPolygonMode(face,mode);
+            int modes[2];
+            glGetIntegerv(GL_POLYGON_MODE,modes);
+            record.polygon_mode_front = modes[0];
+            record.polygon_mode_back = modes[1];
+        }
+
+        void set_line_width(float width) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.line_width == width))
+                return;
+            touch(Field::LineWidth);
+            glLineWidth(width);
+            record.line_width = width;
+        }
+
+        void set_primitive_restart(bool enable) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.primitive_restart == enable))
+                return;
+            touch(Field::PrimitiveRestart);
+            set_capability(GL_PRIMITIVE_RESTART,enable);
+            record.primitive_restart = enable;
+        }
+
+        void set_primitive_restart_index(unsigned int index) noexcept
+        {
+            ensure_synced();
+            if(skip_state(static_cast<unsigned int>(record.primitive_restart_index) == index))
+                return;
+            touch(Field::PrimitiveRestartIndex);
+            glPrimitiveRestartIndex(index);
+            record.primitive_restart_index = static_cast<int>(index);
+        }
+
+        void set_depth_test(bool enable) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.depth_test == enable))
+                return;
+            touch(Field::DepthTest);
+            set_capability(GL_DEPTH_TEST,enable);
+            record.depth_test = enable;
+        }
+
+        void set_depth_mask(bool mask) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.depth_writemask == mask))
+                return;
+            touch(Field::DepthMask);
+            glDepthMask(mask);
+            record.depth_writemask = mask;
+        }
+
+        void set_depth_func(int func) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.depth_func == func))
+                return;
+            touch(Field::DepthFunc);
+            glDepthFunc(func);
+            record.depth_func = func;
+        }
+
+        void set_stencil_test(bool enable) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.stencil_test == enable))
+                return;
+            touch(Field::StencilTest);
+            set_capability(GL_STENCIL_TEST,enable);
+            record.stencil_test = enable;
+        }
+
+        void set_stencil_func(int func,int ref,unsigned int mask) noexcept
+        {
+            ensure_synced();
+            const int value_mask {static_cast<int>(mask)};
+            if(skip_state(record.stencil_func == func && record.stencil_ref == ref && record.stencil_value_mask == value_mask
+                && record.stencil_back_func == func && record.stencil_back_ref == ref && record.stencil_back_value_mask == value_mask))
+                return;
+            touch(Field::StencilFunc);
+            glStencilFunc(func,ref,mask);
+            record.stencil_func = record.stencil_back_func = func;
+            record.stencil_ref = record.stencil_back_ref = ref;
+            record.stencil_value_mask = record.stencil_back_value_mask = value_mask;
+        }
+
+        void set_stencil_mask(unsigned int mask) noexcept
+        {
+            ensure_synced();
+            const int write_mask {static_cast<int>(mask)};
+            if(skip_state(record.stencil_write_mask == write_mask && record.stencil_back_write_mask == write_mask))
+                return;
+            touch(Field::StencilMask);
+            glStencilMask(mask);
+            record.stencil_write_mask = record.stencil_back_write_mask = write_mask;
+        }
+
+        void set_stencil_op(int fail_op,int depth_fail_op,int pass_op) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.stencil_fail_op == fail_op && record.stencil_depth_fail_op == depth_fail_op && record.stencil_pass_op == pass_op
+                && record.stencil_back_fail_op == fail_op && record.stencil_back_depth_fail_op == depth_fail_op && record.stencil_back_pass_op == pass_op))
+                return;
+            touch(Field::StencilOp);
+            glStencilOp(fail_op,depth_fail_op,pass_op);
+            record.stencil_fail_op = record.stencil_back_fail_op = fail_op;
+            record.stencil_depth_fail_op = record.stencil_back_depth_fail_op = depth_fail_op;
+            record.stencil_pass_op = record.stencil_back_pass_op = pass_op;
+        }
+
+        void set_blend(bool enable) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.blend_test == enable))
+                return;
+            touch(Field::BlendTest);
+            set_capability(GL_BLEND,enable);
+            record.blend_test = enable;
+        }
+
+        void set_blend_func(int src_rgb,int dst_rgb,int src_alpha,int dst_alpha) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.blend_src_rgb == src_rgb && record.blend_dst_rgb == dst_rgb
+                && record.blend_src_alpha == src_alpha && record.blend_dst_alpha == dst_alpha))
+                return;
+            touch(Field::BlendFunc);
+            glBlendFuncSeparate(src_rgb,dst_rgb,src_alpha,dst_alpha);
+            record.blend_src_rgb = src_rgb;
+            record.blend_dst_rgb = dst_rgb;
+            record.blend_src_alpha = src_alpha;
+            record.blend_dst_alpha = dst_alpha;
+        }
+
+        void set_blend_color(float r,float g,float b,float a) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.blend_color == std::array<float,4>{r,g,b,a}))
+                return;
+            touch(Field::BlendColor);
+            glBlendColor(r,g,b,a);
+            record.blend_color = {r,g,b,a};
+        }
+
+        void set_cull_face_test(bool enable) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.cullface_test == enable))
+                return;
+            touch(Field::CullFaceTest);
+            set_capability(GL_CULL_FACE,enable);
+            record.cullface_test = enable;
+        }
+
+        void set_cull_face(int mode) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.cullface_mode == mode))
+                return;
+            touch(Field::CullFace);
+            glCullFace(mode);
+            record.cullface_mode = mode;
+        }
+
+        void set_front_face(int mode) noexcept
+        {
+            ensure_synced();
+            if(skip_state(record.front_face == mode))
+                return;
+            touch(Field::FrontFace);
+            glFrontFace(mode);
+            record.front_face = mode;
+        }
+
+        /**
+         * @brief delete a buffer, OpenGL unbinds it from the current bindings
+         *
+         * @param buffer_id
+         */
+        void delete_buffer(unsigned int buffer_id) noexcept
+        {
+            glDeleteBuffers(1,&buffer_id);
+            if(record.vbo_id == static_cast<int>(buffer_id))
+            {
+                touch(Field::ArrayBuffer);
+                record.vbo_id = 0;
+            }
+            if(auto it {vao_ebo_ids.find(record.vao_id)};it != vao_ebo_ids.end() && it->second == static_cast<int>(buffer_id))
+            {
+                touch(Field::ElementBuffer);
+                it->second = 0;
+            }
+        }
+
+        void delete_vertex_array(unsigned int vao_id) noexcept
+        {
+            glDeleteVertexArrays(1,&vao_id);
+            if(record.vao_id == static_cast<int>(vao_id))
+            {
+                touch(Field::VertexArray);
+                record.vao_id = 0;
+            }
+            vao_ebo_ids.erase(vao_id);
+        }
+
+        void delete_texture(unsigned int texture_id) noexcept
+        {
+            glDeleteTextures(1,&texture_id);
+            if(record.texture_2d_id == static_cast<int>(texture_id))
+            {
+                touch(Field::Texture);
+                record.texture_2d_id = 0;
+            }
+        }
+
+        void delete_framebuffer(unsigned int fbo_id) noexcept
+        {
+            glDeleteFramebuffers(1,&fbo_id);
+            if(record.draw_framebuffer_id == static_cast<int>(fbo_id) || record.read_framebuffer_id == static_cast<int>(fbo_id))
+                touch(Field::Framebuffer);
+            if(record.draw_framebuffer_id == static_cast<int>(fbo_id))
+                record.draw_framebuffer_id = 0;
+            if(record.read_framebuffer_id == static_cast<int>(fbo_id))
+                record.read_framebuffer_id = 0;
+        }
+
+        void delete_renderbuffer(unsigned int rbo_id) noexcept
+        {
+            glDeleteRenderbuffers(1,&rbo_id);
+            if(record.renderbuffer_id == static_cast<int>(rbo_id))
+            {
+                touch(Field::Renderbuffer);
+                record.renderbuffer_id = 0;
+            }
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "context.hpp"
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+namespace graphics
+{
+    /**
+     * @brief a piece of a StreamBuffer handed out for one frame
+     *
+     */
+    struct StreamRegion
+    {
+        void* data;             // write pointer, valid until StreamBuffer::commit()
+        std::size_t offset;     // from the start of the buffer, by byte
+        std::size_t size;       // by byte
+
+        /**
+         * @brief Get the index of the first element of the region, use it as the first vertex of a draw
+         *
+         * @param stride    the size of one element, by byte
+         * @return std::size_t
+         */
+        std::size_t get_first(std::size_t stride) const noexcept
+        {
+            return offset / stride;
+        }
+    };
+
+    /**
+     * @brief ring of frame_count frames of storage for geometry rebuilt every frame (UI, particles, debug lines)
+     * @note  regions are mapped with GL_MAP_UNSYNCHRONIZED_BIT, so writing never waits for the GPU.
+     *        a frame of storage is reused only after the fence put behind its draws has signaled.
+     *        OpenGL 3.3 has no persistent mapping, each region is mapped until commit()
+     * @warning commit() before drawing from the buffer, OpenGL can not draw from a mapped buffer
+     *
+     * @tparam frame_count  frames in flight, 3 keeps the CPU a frame ahead without waiting
+     */
+    template <std::size_t frame_count = 3>
+    class StreamBuffer
+    {
+        static_assert(frame_count >= 2,"StreamBuffer needs at least two frames in flight");
+
+    private:
+        unsigned int vbo_id;
+        std::size_t frame_size;
+        std::size_t frame_index {0};
+        std::size_t frame_used {0};
+        std::array<GLsync,frame_count> fences {};
+        bool mapped {false};
+        std::size_t stall_count {0};
+
+        /**
+         * @brief wait until the GPU is done with the frame about to be reused
+         *
+         * @param fence
+         */
+        void wait(GLsync fence) noexcept
+        {
+            GLenum result {glClientWaitSync(fence,0,0)};
+            if(result == GL_TIMEOUT_EXPIRED)
+            {
+                ++stall_count;
+                do
+                    result = glClientWaitSync(fence,GL_SYNC_FLUSH_COMMANDS_BIT,1000000);
+                while(result == GL_TIMEOUT_EXPIRED);
+            }
+            glDeleteSync(fence);
+        }
+
+    public:
+        /**
+         * @brief Construct a new Stream Buffer object
+         *
+         * @param frame_size    storage for one frame, by byte
+         */
+        explicit StreamBuffer(std::size_t frame_size) noexcept
+            : frame_size(frame_size)
+        {
+            glGenBuffers(1,&vbo_id);
+            set_operation("StreamBuffer::StreamBuffer",vbo_id);
+            glBindBuffer(GL_COPY_WRITE_BUFFER,vbo_id);
+            glBufferData(GL_COPY_WRITE_BUFFER,frame_size * frame_count,nullptr,GL_STREAM_DRAW);
+        }
+
+        /**
+         * @brief StreamBuffer can't be copied
+         *
+         */
+        StreamBuffer(StreamBuffer&) = delete;
+
+        ~StreamBuffer() noexcept
+        {
+            commit();
+            for(GLsync fence : fences)
+            {
+                if(fence != nullptr)
+                    glDeleteSync(fence);
+            }
+            status_cache().delete_buffer(vbo_id);
+        }
+
+        /**
+         * @brief map size bytes of the current frame for writing, the previous region is committed first
+         * @warning throw std::runtime_error when the frame has no room left or the mapping fails
+         *
+         * @param size
+         * @param alignment the offset of the region is a multiple of it, pass the vertex stride to draw from it
+         * @return StreamRegion
+         */
+        StreamRegion allocate(std::size_t size,std::size_t alignment = 16) noexcept(false)
+        {
+            commit();
+
+            const std::size_t base {frame_index * frame_size};
+            const std::size_t offset {(base + frame_used + alignment - 1) / alignment * alignment};
+            if(offset + size > base + frame_size)
+                throw std::runtime_error("StreamBuffer frame is full");
+
+            set_operation("StreamBuffer::allocate",vbo_id);
+            glBindBuffer(GL_COPY_WRITE_BUFFER,vbo_id);
+            void* data {glMapBufferRange(GL_COPY_WRITE_BUFFER,offset,size,GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT)};
+            if(data == nullptr)
+                throw std::runtime_error("failed to map StreamBuffer region");
+
+            mapped = true;
+            frame_used = offset + size - base;
+            return StreamRegion {data,offset,size};
+        }
+
+        /**
+         * @brief copy data into a new region of the current frame
+         *
+         * @tparam T
+         * @param data
+         * @param alignment
+         * @return StreamRegion    already committed, data is nullptr
+         */
+        template <typename T>
+        StreamRegion push(std::span<const T> data,std::size_t alignment = sizeof(T)) noexcept(false)
+        {
+            StreamRegion region {allocate(data.size_bytes(),alignment)};
+            std::memcpy(region.data,data.data(),data.size_bytes());
+            commit();
+            region.data = nullptr;
+            return region;
+        }
+
+        /**
+         * @brief unmap the region handed out last, nothing happens if there is none
+         *
+         */
+        void commit() noexcept
+        {
+            if(!mapped)
+                return;
+            glBindBuffer(GL_COPY_WRITE_BUFFER,vbo_id);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            mapped = false;
+        }
+
+        /**
+         * @brief fence the draws of the current frame and move to the next one, call it once per frame after the draws
+         * @note  waits only if the GPU is still frame_count - 1 frames behind
+         *
+         */
+        void end_frame() noexcept
+        {
+            commit();
+            fences[frame_index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+
+            frame_index = (frame_index + 1) % frame_count;
+            frame_used = 0;
+            if(fences[frame_index] != nullptr)
+            {
+                wait(fences[frame_index]);
+                fences[frame_index] = nullptr;
+            }
+        }
+
+        unsigned int get_vbo_id() const noexcept
+        {
+            return vbo_id;
+        }
+
+        /**
+         * @brief Get the storage of one frame, by byte
+         *
+         * @return std::size_t
+         */
+        std::size_t get_frame_size() const noexcept
+        {
+            return frame_size;
+        }
+
+        /**
+         * @brief how many times end_frame() had to wait for the GPU
+         *
+         * @return std::size_t
+         */
+        std::size_t get_stall_count() const noexcept
+        {
+            return stall_count;
+        }
+    };
+}
\ No newline at end of file
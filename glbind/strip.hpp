@@ -0,0 +1,167 @@
+#pragma once
+
+#include "vertex.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace graphics
+{
+    /**
+     * @brief turn an indexed triangle list into triangle strips separated by restart, keeping the winding of every triangle
+     * @note  draw the result as Primitives::TriangleStrip from an ElementBuffer constructed with the same restart index.
+     *        a strip grows greedily from the triangle with the fewest free neighbours, degenerate triangles are dropped
+     *
+     * @param triangles three indices per triangle, a trailing partial triangle is ignored
+     * @param restart   must not be an index of triangles
+     * @return std::vector<unsigned int>
+     */
+    inline std::vector<unsigned int> stripify(std::span<const unsigned int> triangles,unsigned int restart = primitive_restart_index) noexcept(false)
+    {
+        const std::size_t triangle_count {triangles.size() / 3};
+        const auto corner {[&](std::size_t triangle,std::size_t i)
+        {
+            return triangles[triangle * 3 + i % 3];
+        }};
+        const auto edge_key {[](unsigned int from,unsigned int to)
+        {
+            return (std::uint64_t(from) << 32) | to;
+        }};
+
+        // directed edges sorted by key, the triangle across edge (a,b) holds the directed edge (b,a)
+        struct Edge
+        {
+            std::uint64_t key;
+            std::uint32_t triangle;
+        };
+        std::vector<Edge> edges;
+        edges.reserve(triangle_count * 3);
+        std::vector<bool> used(triangle_count,false);
+        for(std::size_t t = 0;t < triangle_count;t++)
+        {
+            const unsigned int a {corner(t,0)},b {corner(t,1)},c {corner(t,2)};
+            if(a == b || b == c || c == a)
+            {
+                used[t] = true;
+                continue;
+            }
+            for(std::size_t i = 0;i < 3;i++)
+                edges.push_back(Edge {edge_key(corner(t,i),corner(t,i + 1)),static_cast<std::uint32_t>(t)});
+        }
+        std::sort(edges.begin(),edges.end(),[](const Edge& x,const Edge& y){return x.key < y.key;});
+
+        const auto for_each_on_edge {[&](unsigned int from,unsigned int to,auto&& action)
+        {
+            const std::uint64_t key {edge_key(from,to)};
+            auto it {std::lower_bound(edges.begin(),edges.end(),key,[](const Edge& e,std::uint64_t k){return e.key < k;})};
+            for(;it != edges.end() && it->key == key;++it)
+            {
+                if(!used[it->triangle])
+                    action(it->triangle);
+            }
+        }};
+        const auto free_neighbours {[&](std::size_t t)
+        {
+            std::size_t count {0};
+            for(std::size_t i = 0;i < 3;i++)
+                for_each_on_edge(corner(t,i + 1),corner(t,i),[&](std::uint32_t){++count;});
+            return count;
+        }};
+
+        // start triangles bucketed by free neighbours (3 or more share the last bucket), stale entries are skipped
+        std::array<std::vector<std::uint32_t>,4> starts;
+        std::vector<std::uint8_t> neighbours(triangle_count,0);
+        for(std::size_t t = 0;t < triangle_count;t++)
+        {
+            if(used[t])
+                continue;
+            neighbours[t] = static_cast<std::uint8_t>(std::min<std::size_t>(free_neighbours(t),3));
+            starts[neighbours[t]].push_back(static_cast<std::uint32_t>(t));
+        }
+        const auto take {[&](std::size_t t)
+        {
+            used[t] = true;
+            for(std::size_t i = 0;i < 3;i++)
+            {
+                for_each_on_edge(corner(t,i + 1),corner(t,i),[&](std::uint32_t n)
+                {
+                    if(neighbours[n] != 0)
+                        starts[--neighbours[n]].push_back(n);
+                });
+            }
+        }};
+        const auto next_start {[&]() -> std::size_t
+        {
+            for(auto& bucket : starts)
+            {
+                while(!bucket.empty())
+                {
+                    const std::uint32_t t {bucket.back()};
+                    bucket.pop_back();
+                    if(!used[t] && &starts[neighbours[t]] == &bucket)
+                        return t;
+                }
+            }
+            return triangle_count;
+        }};
+
+        std::vector<unsigned int> strips;
+        strips.reserve(triangles.size());
+        std::vector<unsigned int> strip;
+        for(std::size_t t {next_start()};t != triangle_count;t = next_start())
+        {
+            // rotate the start triangle so that its second edge leads to a free neighbour, if any
+            std::size_t rotation {0};
+            for(std::size_t i = 0;i < 3;i++)
+            {
+                bool found {false};
+                for_each_on_edge(corner(t,i + 2),corner(t,i + 1),[&](std::uint32_t){found = true;});
+                if(found)
+                {
+                    rotation = i;
+                    break;
+                }
+            }
+            strip.assign({corner(t,rotation),corner(t,rotation + 1),corner(t,rotation + 2)});
+            take(t);
+
+            while(true)
+            {
+                // triangle k of the strip is (s[k],s[k+1],s[k+2]) when k is even and (s[k+1],s[k],s[k+2]) when odd
+                const unsigned int a {strip[strip.size() - 2]},b {strip[strip.size() - 1]};
+                const bool even {(strip.size() - 2) % 2 == 0};
+                std::size_t best {triangle_count};
+                std::size_t best_neighbours {0};
+                for_each_on_edge(even ? a : b,even ? b : a,[&](std::uint32_t n)
+                {
+                    if(best == triangle_count || neighbours[n] < best_neighbours)
+                    {
+                        best = n;
+                        best_neighbours = neighbours[n];
+                    }
+                });
+                if(best == triangle_count)
+                    break;
+
+                const unsigned int from {even ? a : b},to {even ? b : a};
+                for(std::size_t i = 0;i < 3;i++)
+                {
+                    if(corner(best,i) == from && corner(best,i + 1) == to)
+                    {
+                        strip.push_back(corner(best,i + 2));
+                        break;
+                    }
+                }
+                take(best);
+            }
+
+            if(!strips.empty())
+                strips.push_back(restart);
+            strips.insert(strips.end(),strip.begin(),strip.end());
+        }
+        return strips;
+    }
+}
\ No newline at end of file
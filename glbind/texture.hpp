@@ -151,9 +151,10 @@ namespace graphics
         Texture(const unsigned char* const data,unsigned int channels,unsigned int x,unsigned int y,unsigned int w,unsigned int h) noexcept
             : width(w),height(h)
         {
-            Scope([&]()
+            RestoreScope<State::Texture>([&]()
             {
                 glGenTextures(1,&texture_id);
+                set_operation("Texture::Texture",texture_id);
                 glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_REPEAT);
                 glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_REPEAT);
                 glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
@@ -200,7 +201,10 @@ namespace graphics
                 else if(channels == 4)
                     img_channel_enum = GL_RGBA;
 
-                glBindTexture(static_cast<GLenum>(type),texture_id);
+                if constexpr(type == TextureType::Texture2D)
+                    status_cache().bind_texture_2d(texture_id);
+                else
+                    glBindTexture(static_cast<GLenum>(type),texture_id);
 
                 if constexpr(type == TextureType::Texture2D)
                 {
@@ -236,7 +240,7 @@ namespace graphics
          */
         ~Texture() noexcept
         {
-            glDeleteTextures(1,&texture_id);
+            status_cache().delete_texture(texture_id);
         }
 
         /**
@@ -247,7 +251,7 @@ namespace graphics
         {
             if constexpr(type == TextureType::Texture2D)
             {
-                glBindTexture(GL_TEXTURE_2D,texture_id);
+                status_cache().bind_texture_2d(texture_id);
             }
             else if constexpr(type == TextureType::CubeMap)
             {
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace graphics
+{
+    /**
+     * @brief a fixed set of worker threads running submitted tasks in order
+     * @warning a task must not wait for another task of the same pool, it may never run
+     *
+     */
+    class ThreadPool
+    {
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping {false};
+
+        void work() noexcept
+        {
+            while(true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock,[this](){return stopping || !tasks.empty();});
+                    if(tasks.empty())
+                        return;
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        /**
+         * @brief Construct a new Thread Pool object
+         *
+         * @param thread_count at least 1
+         */
+        explicit ThreadPool(std::size_t thread_count = std::max(1u,std::thread::hardware_concurrency())) noexcept(false)
+        {
+            thread_count = std::max<std::size_t>(thread_count,1);
+            workers.reserve(thread_count);
+            for(std::size_t i = 0;i < thread_count;i++)
+                workers.emplace_back([this](){work();});
+        }
+
+        /**
+         * @brief ThreadPool can't be copied
+         *
+         */
+        ThreadPool(ThreadPool&) = delete;
+
+        /**
+         * @brief Destroy the Thread Pool object, the tasks already submitted still run
+         *
+         */
+        ~ThreadPool() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            condition.notify_all();
+            for(auto& worker : workers)
+                worker.join();
+        }
+
+        /**
+         * @brief queue a task, its result or exception comes back through the future
+         *
+         * @tparam F
+         * @param task
+         * @return std::future<std::invoke_result_t<F>>
+         */
+        template <typename F>
+        std::future<std::invoke_result_t<F>> submit(F&& task) noexcept(false)
+        {
+            using Result = std::invoke_result_t<F>;
+            const auto packaged {std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task))};
+            std::future<Result> result {packaged->get_future()};
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.emplace_back([packaged](){(*packaged)();});
+            }
+            condition.notify_one();
+            return result;
+        }
+
+        std::size_t get_thread_count() const noexcept
+        {
+            return workers.size();
+        }
+    };
+
+    /**
+     * @brief wait until every task behind futures has finished, without taking results or exceptions out
+     * @note  call it before leaving a function whose tasks read its locals or the data of its caller,
+     *        also when unwinding, then get() the results
+     *
+     * @tparam T
+     * @param futures
+     */
+    template <typename T>
+    inline void wait_all(std::vector<std::future<T>>& futures) noexcept
+    {
+        for(auto& future : futures)
+        {
+            if(future.valid())
+                future.wait();
+        }
+    }
+
+    /**
+     * @brief the pool shared by the CPU side tools of glbind, started on first use
+     *
+     * @return ThreadPool&
+     */
+    inline ThreadPool& default_thread_pool() noexcept(false)
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+}
\ No newline at end of file
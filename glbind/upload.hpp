@@ -0,0 +1,351 @@
+#pragma once
+
+#include "vertex.hpp"
+#include <glad/glad.h>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace graphics
+{
+    enum class UploadState
+    {
+        Staging,    // the staging memory is mapped, the CPU is filling it
+        Copying,    // the copy into the destination is queued, its fence has not signaled yet
+        Resident    // the destination holds the data, draw from it
+    };
+
+    /**
+     * @brief one upload of an UploadQueue, copies share its state so a mesh can keep one to test residency
+     * @note  get_staging() and finish() may be called from any thread, the rest of the upload happens in UploadQueue::update()
+     *
+     */
+    class UploadTicket
+    {
+    private:
+        friend class UploadQueue;
+
+        struct Shared
+        {
+            std::atomic<UploadState> state {UploadState::Staging};
+            std::atomic<bool> filled {false};
+        };
+
+        std::shared_ptr<Shared> shared;
+        std::span<std::byte> staging;
+
+        UploadTicket(std::shared_ptr<Shared> shared,std::span<std::byte> staging) noexcept
+            : shared(std::move(shared)),staging(staging)
+        {
+        }
+
+    public:
+        UploadTicket() noexcept = default;
+
+        /**
+         * @brief Get the mapped staging memory to write the data into
+         * @warning valid only until finish()
+         *
+         * @return std::span<std::byte>
+         */
+        std::span<std::byte> get_staging() const noexcept
+        {
+            return staging;
+        }
+
+        /**
+         * @brief Get the staging memory as elements of T
+         *
+         * @tparam T
+         * @return std::span<T>
+         */
+        template <typename T>
+        std::span<T> get_staging_as() const noexcept
+        {
+            return {reinterpret_cast<T*>(staging.data()),staging.size() / sizeof(T)};
+        }
+
+        /**
+         * @brief the staging memory is written, the next UploadQueue::update() may copy it
+         *
+         */
+        void finish() noexcept
+        {
+            if(shared)
+                shared->filled.store(true,std::memory_order_release);
+        }
+
+        UploadState get_state() const noexcept
+        {
+            return shared ? shared->state.load(std::memory_order_acquire) : UploadState::Resident;
+        }
+
+        bool is_resident() const noexcept
+        {
+            return get_state() == UploadState::Resident;
+        }
+    };
+
+    /**
+     * @brief a buffer the queue can grow and upload into, such as VertexBuffer<type> or StructVertexBuffer<V>
+     *
+     */
+    template <typename B>
+    concept UploadDestination = VertexBufferService<B> && requires(B b,std::size_t n)
+    {
+        typename B::value_type;
+        b.resize(n);
+        {b.get_len()} -> std::same_as<std::size_t>;
+    };
+
+    /**
+     * @brief uploads that never block the GL thread: the data goes into mapped staging buffers, possibly from
+     *        worker threads, then update() copies it with glCopyBufferSubData and fences the copies
+     * @note  OpenGL 3.3 maps a buffer once at a time, so every upload in flight has its own staging buffer.
+     *        staging buffers are reused once the fence behind their copy signals
+     * @warning a destination must outlive its upload, and must not be drawn from before the ticket is resident
+     *
+     */
+    class UploadQueue
+    {
+    private:
+        static constexpr std::size_t min_staging_size {1 << 16};
+
+        struct Staging
+        {
+            unsigned int buffer_id;
+            std::size_t capacity;
+        };
+
+        struct Upload
+        {
+            std::shared_ptr<UploadTicket::Shared> shared;
+            std::size_t staging;
+            unsigned int destination;
+            std::size_t offset;
+            std::size_t size;
+        };
+
+        struct Batch
+        {
+            GLsync fence;
+            std::vector<Upload> uploads;
+        };
+
+        std::vector<Staging> stagings;
+        std::vector<std::size_t> free_stagings;
+        std::vector<Upload> writing;
+        std::deque<Batch> copying;
+        std::size_t bytes_per_update;
+
+        std::size_t take_staging(std::size_t size) noexcept(false)
+        {
+            // the smallest free one that fits
+            auto best {free_stagings.end()};
+            for(auto it {free_stagings.begin()};it != free_stagings.end();++it)
+            {
+                if(stagings[*it].capacity >= size && (best == free_stagings.end() || stagings[*it].capacity < stagings[*best].capacity))
+                    best = it;
+            }
+            if(best != free_stagings.end())
+            {
+                const std::size_t index {*best};
+                free_stagings.erase(best);
+                return index;
+            }
+
+            Staging staging {0,std::bit_ceil(std::max(size,min_staging_size))};
+            glGenBuffers(1,&staging.buffer_id);
+            glBindBuffer(GL_COPY_READ_BUFFER,staging.buffer_id);
+            glBufferData(GL_COPY_READ_BUFFER,staging.capacity,nullptr,GL_STREAM_DRAW);
+            stagings.push_back(staging);
+            return stagings.size() - 1;
+        }
+
+        /**
+         * @brief retire the batches whose copies are done, in order
+         *
+         * @param block wait for every batch instead of only polling
+         */
+        void retire(bool block) noexcept
+        {
+            while(!copying.empty())
+            {
+                Batch& batch {copying.front()};
+                GLenum result {glClientWaitSync(batch.fence,GL_SYNC_FLUSH_COMMANDS_BIT,0)};
+                while(block && result == GL_TIMEOUT_EXPIRED)
+                    result = glClientWaitSync(batch.fence,GL_SYNC_FLUSH_COMMANDS_BIT,1000000);
+                if(result == GL_TIMEOUT_EXPIRED)
+                    return;
+
+                glDeleteSync(batch.fence);
+                for(const Upload& upload : batch.uploads)
+                {
+                    upload.shared->state.store(UploadState::Resident,std::memory_order_release);
+                    free_stagings.push_back(upload.staging);
+                }
+                copying.pop_front();
+            }
+        }
+
+    public:
+        /**
+         * @brief Construct a new Upload Queue object
+         *
+         * @param bytes_per_update  copies issued by one update(), at least one upload goes each time
+         */
+        explicit UploadQueue(std::size_t bytes_per_update = 8 << 20) noexcept
+            : bytes_per_update(bytes_per_update)
+        {
+        }
+
+        /**
+         * @brief UploadQueue can't be copied
+         *
+         */
+        UploadQueue(UploadQueue&) = delete;
+
+        ~UploadQueue() noexcept
+        {
+            for(const Batch& batch : copying)
+                glDeleteSync(batch.fence);
+            for(const Staging& staging : stagings)
+                status_cache().delete_buffer(staging.buffer_id);
+        }
+
+        /**
+         * @brief map staging memory for size bytes going to offset in a buffer, on the GL thread
+         * @warning throw std::runtime_error when the mapping fails
+         *
+         * @param buffer_id the destination, its storage must already hold offset + size bytes
+         * @param offset    by byte
+         * @param size      by byte
+         * @return UploadTicket
+         */
+        UploadTicket stage(unsigned int buffer_id,std::size_t offset,std::size_t size) noexcept(false)
+        {
+            const auto shared {std::make_shared<UploadTicket::Shared>()};
+            if(size == 0)
+            {
+                shared->state.store(UploadState::Resident);
+                return UploadTicket(shared,{});
+            }
+
+            set_operation("UploadQueue::stage",buffer_id);
+            const std::size_t staging {take_staging(size)};
+            glBindBuffer(GL_COPY_READ_BUFFER,stagings[staging].buffer_id);
+            // the fence of its last copy has signaled, nothing reads this buffer any more
+            void* data {glMapBufferRange(GL_COPY_READ_BUFFER,0,size,GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT)};
+            if(data == nullptr)
+            {
+                free_stagings.push_back(staging);
+                throw std::runtime_error("failed to map staging buffer");
+            }
+
+            writing.push_back(Upload {shared,staging,buffer_id,offset,size});
+            return UploadTicket(shared,{static_cast<std::byte*>(data),size});
+        }
+
+        /**
+         * @brief grow destination to cover count elements from first, then map staging memory for them
+         *
+         * @tparam B
+         * @param destination
+         * @param first by count
+         * @param count
+         * @return UploadTicket
+         */
+        template <UploadDestination B>
+        UploadTicket stage(B& destination,std::size_t first,std::size_t count) noexcept(false)
+        {
+            using T = typename B::value_type;
+            if(first + count > destination.get_len())
+                destination.resize(first + count);
+            return stage(destination.get_vbo_id(),first * sizeof(T),count * sizeof(T));
+        }
+
+        /**
+         * @brief copy the finished uploads into their destinations and fence them, then mark the uploads
+         *        whose fence signaled as resident. call it once per frame on the GL thread, it never waits
+         * @warning throw std::runtime_error when the driver lost the content of a staging buffer
+         *
+         */
+        void update() noexcept(false)
+        {
+            retire(false);
+
+            Batch batch {nullptr,{}};
+            std::size_t bytes {0};
+            for(auto it {writing.begin()};it != writing.end() && (bytes < bytes_per_update || batch.uploads.empty());)
+            {
+                if(!it->shared->filled.load(std::memory_order_acquire))
+                {
+                    ++it;
+                    continue;
+                }
+
+                set_operation("UploadQueue::update",it->destination);
+                glBindBuffer(GL_COPY_READ_BUFFER,stagings[it->staging].buffer_id);
+                if(glUnmapBuffer(GL_COPY_READ_BUFFER) == GL_FALSE)
+                    throw std::runtime_error("staging buffer content lost");
+                glBindBuffer(GL_COPY_WRITE_BUFFER,it->destination);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER,GL_COPY_WRITE_BUFFER,0,it->offset,it->size);
+                it->shared->state.store(UploadState::Copying,std::memory_order_release);
+
+                bytes += it->size;
+                batch.uploads.push_back(std::move(*it));
+                it = writing.erase(it);
+            }
+
+            if(!batch.uploads.empty())
+            {
+                batch.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+                copying.push_back(std::move(batch));
+            }
+        }
+
+        /**
+         * @brief copy every finished upload and wait until all copies are resident, for loading screens and shutdown
+         *
+         */
+        void flush() noexcept(false)
+        {
+            const std::size_t limit {bytes_per_update};
+            bytes_per_update = static_cast<std::size_t>(-1);
+            update();
+            bytes_per_update = limit;
+            retire(true);
+        }
+
+        /**
+         * @brief Get the number of uploads staged or copying
+         *
+         * @return std::size_t
+         */
+        std::size_t get_pending_count() const noexcept
+        {
+            std::size_t count {writing.size()};
+            for(const Batch& batch : copying)
+                count += batch.uploads.size();
+            return count;
+        }
+
+        /**
+         * @brief Get the total size of the staging buffers, by byte
+         *
+         * @return std::size_t
+         */
+        std::size_t get_staging_size() const noexcept
+        {
+            std::size_t size {0};
+            for(const Staging& staging : stagings)
+                size += staging.capacity;
+            return size;
+        }
+    };
+}
\ No newline at end of file
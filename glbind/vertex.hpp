@@ -1,12 +1,20 @@
 #pragma once
 
 #include "scope.hpp"
+#include "dirty_ranges.hpp"
+#include "layout.hpp"
 #include <glad/glad.h>
 #include <array>
 #include <concepts>
 #include <stdexcept>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <optional>
+#include <span>
 #include <type_traits>
+#include <vector>
 
 namespace graphics
 {
@@ -15,11 +23,382 @@ namespace graphics
         Static,Dynamic,Stream
     };
 
-    template <BufferType type,std::size_t len>
+    /**
+     * @brief usage hint of a buffer type for glBufferData
+     *
+     * @tparam type
+     * @return GLenum
+     */
+    template <BufferType type>
+    constexpr GLenum buffer_usage() noexcept
+    {
+        if constexpr(type == BufferType::Static)
+            return GL_STATIC_DRAW;
+        else if constexpr(type == BufferType::Dynamic)
+            return GL_DYNAMIC_DRAW;
+        else
+            return GL_STREAM_DRAW;
+    }
+
+    /**
+     * @brief the narrowest index type able to address vertex_count vertices
+     *
+     * @param vertex_count
+     * @return GLenum GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+     */
+    constexpr GLenum index_type_for(std::size_t vertex_count) noexcept
+    {
+        if(vertex_count <= 0x100)
+            return GL_UNSIGNED_BYTE;
+        else if(vertex_count <= 0x10000)
+            return GL_UNSIGNED_SHORT;
+        else
+            return GL_UNSIGNED_INT;
+    }
+
+    /**
+     * @brief the size of one index, by byte
+     *
+     * @param index_type
+     * @return std::size_t
+     */
+    constexpr std::size_t index_size(GLenum index_type) noexcept
+    {
+        if(index_type == GL_UNSIGNED_BYTE)
+            return 1;
+        else if(index_type == GL_UNSIGNED_SHORT)
+            return 2;
+        else
+            return 4;
+    }
+
+    /**
+     * @brief the restart index ElementBuffer takes by default, it never addresses a vertex
+     *
+     */
+    constexpr unsigned int primitive_restart_index {0xFFFFFFFF};
+
+    /**
+     * @brief the restart index as stored in an index buffer of index_type, the largest value of the type
+     *
+     * @param index_type
+     * @return unsigned int
+     */
+    constexpr unsigned int restart_index_of(GLenum index_type) noexcept
+    {
+        if(index_type == GL_UNSIGNED_BYTE)
+            return 0xFF;
+        else if(index_type == GL_UNSIGNED_SHORT)
+            return 0xFFFF;
+        else
+            return 0xFFFFFFFF;
+    }
+
+    /**
+     * @brief the index type needed by some indices
+     *
+     * @param indices
+     * @param restart   the restart index of indices, if any. it takes the largest value of the index type
+     *                  so the type must hold one more value than the vertices
+     * @return GLenum
+     */
+    inline GLenum index_type_of(std::span<const unsigned int> indices,std::optional<unsigned int> restart = std::nullopt) noexcept
+    {
+        std::size_t count {0};
+        for(const unsigned int index : indices)
+        {
+            if(index != restart)
+                count = std::max(count,std::size_t(index) + 1);
+        }
+        return index_type_for(restart ? count + 1 : count);
+    }
+
+    /**
+     * @brief store indices as index_type, every index must fit in it
+     *
+     * @param indices
+     * @param index_type
+     * @param restart   stored as restart_index_of(index_type)
+     * @return std::vector<std::byte>
+     */
+    inline std::vector<std::byte> narrow_indices(std::span<const unsigned int> indices,GLenum index_type,std::optional<unsigned int> restart = std::nullopt) noexcept(false)
+    {
+        std::vector<std::byte> bytes(indices.size() * index_size(index_type));
+        const auto store {[&]<typename T>(T*)
+        {
+            for(std::size_t i = 0;i < indices.size();i++)
+            {
+                const T index {indices[i] == restart ? static_cast<T>(restart_index_of(index_type)) : static_cast<T>(indices[i])};
+                std::memcpy(bytes.data() + i * sizeof(T),&index,sizeof(T));
+            }
+        }};
+        if(index_type == GL_UNSIGNED_BYTE)
+            store(static_cast<std::uint8_t*>(nullptr));
+        else if(index_type == GL_UNSIGNED_SHORT)
+            store(static_cast<std::uint16_t*>(nullptr));
+        else
+            store(static_cast<std::uint32_t*>(nullptr));
+        return bytes;
+    }
+
+    /**
+     * @brief the reverse of narrow_indices()
+     *
+     * @param bytes
+     * @param index_type
+     * @param restart
+     * @return std::vector<unsigned int>
+     */
+    inline std::vector<unsigned int> widen_indices(std::span<const std::byte> bytes,GLenum index_type,std::optional<unsigned int> restart = std::nullopt) noexcept(false)
+    {
+        std::vector<unsigned int> indices(bytes.size() / index_size(index_type));
+        const auto load {[&]<typename T>(T*)
+        {
+            for(std::size_t i = 0;i < indices.size();i++)
+            {
+                T index;
+                std::memcpy(&index,bytes.data() + i * sizeof(T),sizeof(T));
+                indices[i] = restart && index == static_cast<T>(restart_index_of(index_type)) ? *restart : index;
+            }
+        }};
+        if(index_type == GL_UNSIGNED_BYTE)
+            load(static_cast<std::uint8_t*>(nullptr));
+        else if(index_type == GL_UNSIGNED_SHORT)
+            load(static_cast<std::uint16_t*>(nullptr));
+        else
+            load(static_cast<std::uint32_t*>(nullptr));
+        return indices;
+    }
+
+    /**
+     * @brief a buffer sized at runtime, the storage in OpenGL (capacity) grows geometrically and is never shrunk
+     * @note  uploads go through GL_COPY_WRITE_BUFFER, so no binding tracked by the status cache is touched
+     *        and the buffer keeps its name when it grows (vertex arrays pointing at it stay valid)
+     *
+     * @tparam T    element type
+     * @tparam type
+     */
+    template <typename T,BufferType type>
+    class GrowableBuffer
+    {
+    private:
+        unsigned int buffer_id;
+        std::size_t size {0};
+        std::size_t capacity {0};
+        const char* name;
+        StagedWrites<T> writes;
+
+        /**
+         * @brief give the buffer new storage, the first size elements are copied over if keep is true
+         *
+         * @param new_capacity
+         * @param keep
+         */
+        void reallocate(std::size_t new_capacity,bool keep) noexcept
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER,buffer_id);
+            if(!keep || size == 0)
+            {
+                glBufferData(GL_COPY_WRITE_BUFFER,new_capacity * sizeof(T),nullptr,buffer_usage<type>());
+                capacity = new_capacity;
+                return;
+            }
+
+            // park the content in a temporary buffer, the name of this one must not change
+            unsigned int temp_id;
+            glGenBuffers(1,&temp_id);
+            glBindBuffer(GL_COPY_READ_BUFFER,temp_id);
+            glBufferData(GL_COPY_READ_BUFFER,size * sizeof(T),nullptr,GL_STREAM_COPY);
+            glCopyBufferSubData(GL_COPY_WRITE_BUFFER,GL_COPY_READ_BUFFER,0,0,size * sizeof(T));
+            glBufferData(GL_COPY_WRITE_BUFFER,new_capacity * sizeof(T),nullptr,buffer_usage<type>());
+            glCopyBufferSubData(GL_COPY_READ_BUFFER,GL_COPY_WRITE_BUFFER,0,0,size * sizeof(T));
+            glDeleteBuffers(1,&temp_id);
+            capacity = new_capacity;
+        }
+
+        std::size_t grown_capacity(std::size_t required) const noexcept
+        {
+            return std::max(required,capacity * 2);
+        }
+
+    protected:
+        explicit GrowableBuffer(const char* name) noexcept
+            : name(name)
+        {
+            glGenBuffers(1,&buffer_id);
+        }
+
+        GrowableBuffer(const char* name,std::span<const T> data) noexcept
+            : GrowableBuffer(name)
+        {
+            update(data);
+        }
+
+        ~GrowableBuffer() noexcept
+        {
+            status_cache().delete_buffer(buffer_id);
+        }
+
+        unsigned int get_buffer_id() const noexcept
+        {
+            return buffer_id;
+        }
+
+    public:
+        using value_type = T;
+
+        GrowableBuffer(GrowableBuffer&) = delete;
+
+        /**
+         * @brief make room for at least new_capacity elements, keep the content
+         *
+         * @param new_capacity
+         */
+        void reserve(std::size_t new_capacity) noexcept
+        {
+            if(new_capacity <= capacity)
+                return;
+            set_operation(name,buffer_id);
+            reallocate(new_capacity,true);
+        }
+
+        /**
+         * @brief set the number of elements in use without uploading anything, the content is kept up to new_len.
+         *        new elements are undefined until written, such as by an UploadQueue
+         * @note  the storage grows geometrically like append(), so growing by small steps stays linear
+         *
+         * @param new_len
+         */
+        void resize(std::size_t new_len) noexcept
+        {
+            if(new_len > capacity)
+            {
+                set_operation(name,buffer_id);
+                reallocate(grown_capacity(new_len),true);
+            }
+            else if(new_len < size)
+            {
+                // pending writes may reach past the new end
+                flush();
+            }
+            size = new_len;
+        }
+
+        /**
+         * @brief replace the whole content, the storage is only reallocated when data does not fit
+         *
+         * @param data
+         */
+        void update(std::span<const T> data) noexcept
+        {
+            set_operation(name,buffer_id);
+            if(data.size() > capacity)
+                reallocate(grown_capacity(data.size()),false);
+            else
+                glBindBuffer(GL_COPY_WRITE_BUFFER,buffer_id);
+
+            size = data.size();
+            writes.discard();
+            if(!data.empty())
+                glBufferSubData(GL_COPY_WRITE_BUFFER,0,data.size_bytes(),data.data());
+        }
+
+        /**
+         * @brief overwrite part of the content, nothing is uploaded until flush()
+         * @warning throw std::out_of_range when data goes past get_len()
+         *
+         * @param offset    by count
+         * @param data
+         */
+        void write(std::size_t offset,std::span<const T> data) noexcept(false)
+        {
+            writes.write(offset,data,size);
+        }
+
+        /**
+         * @brief upload the writes made since the last flush, one glBufferSubData per coalesced dirty range
+         *
+         */
+        void flush() noexcept
+        {
+            if(writes.empty())
+                return;
+
+            set_operation(name,buffer_id);
+            glBindBuffer(GL_COPY_WRITE_BUFFER,buffer_id);
+            writes.flush([](std::size_t offset,std::span<const T> data)
+            {
+                glBufferSubData(GL_COPY_WRITE_BUFFER,offset * sizeof(T),data.size_bytes(),data.data());
+            });
+        }
+
+        /**
+         * @brief Get the dirty ranges waiting for flush()
+         *
+         * @return const DirtyRanges&
+         */
+        const DirtyRanges& get_dirty_ranges() const noexcept
+        {
+            return writes.get_dirty_ranges();
+        }
+
+        /**
+         * @brief add data after the current content
+         *
+         * @param data
+         */
+        void append(std::span<const T> data) noexcept
+        {
+            if(data.empty())
+                return;
+
+            set_operation(name,buffer_id);
+            if(size + data.size() > capacity)
+                reallocate(grown_capacity(size + data.size()),true);
+            else
+                glBindBuffer(GL_COPY_WRITE_BUFFER,buffer_id);
+
+            glBufferSubData(GL_COPY_WRITE_BUFFER,size * sizeof(T),data.size_bytes(),data.data());
+            size += data.size();
+        }
+
+        /**
+         * @brief forget the content, the storage is kept for the next update() or append()
+         *
+         */
+        void clear() noexcept
+        {
+            size = 0;
+            writes.discard();
+        }
+
+        /**
+         * @brief Get the number of elements in use
+         *
+         * @return std::size_t
+         */
+        std::size_t get_len() const noexcept
+        {
+            return size;
+        }
+
+        /**
+         * @brief Get the number of elements the storage in OpenGL can hold
+         *
+         * @return std::size_t
+         */
+        std::size_t get_capacity() const noexcept
+        {
+            return capacity;
+        }
+    };
+
+    template <BufferType type,std::size_t len = std::dynamic_extent>
     class VertexBuffer
     {
     private:
         unsigned int vbo_id;
+        StagedWrites<float> writes;
 
         /**
          * @brief Create a vbo object and fill Vertex Buffer in OpenGL
@@ -64,17 +443,18 @@ namespace graphics
          */
         ~VertexBuffer() noexcept
         {
-            glDeleteBuffers(1,&vbo_id);
+            status_cache().delete_buffer(vbo_id);
         }
 
         /**
-         * @brief update Vertex Buffer in OpenGL
+         * @brief update Vertex Buffer in OpenGL, reallocates the storage and drops the writes not flushed yet
          * 
          * @param arr 
          */
-        void update(const std::array<float,len>& arr) const noexcept
+        void update(const std::array<float,len>& arr) noexcept
         {
-            Scope([&]()
+            writes.discard();
+            RestoreScope<State::ArrayBuffer>([&]()
             {
                 int buffer_type_enum;
                 if constexpr(type == BufferType::Static)
@@ -84,11 +464,55 @@ namespace graphics
                 else if constexpr(type == BufferType::Stream)
                     buffer_type_enum = GL_STREAM_DRAW;
                 
-                glBindBuffer(GL_ARRAY_BUFFER,vbo_id);
+                set_operation("VertexBuffer::update",vbo_id);
+                status_cache().bind_buffer(GL_ARRAY_BUFFER,vbo_id);
                 glBufferData(GL_ARRAY_BUFFER,sizeof(arr),arr.data(),buffer_type_enum);
             });
         }
 
+        /**
+         * @brief overwrite part of the vertex data, nothing is uploaded until flush()
+         * @note  writes made during a frame are coalesced, flush once before drawing
+         * @warning throw std::out_of_range when data goes past len
+         *
+         * @param offset    by count
+         * @param data
+         */
+        void write(std::size_t offset,std::span<const float> data) noexcept(false)
+        {
+            writes.write(offset,data,len);
+        }
+
+        /**
+         * @brief upload the writes made since the last flush, one glBufferSubData per coalesced dirty range
+         *
+         */
+        void flush() noexcept
+        {
+            if(writes.empty())
+                return;
+
+            RestoreScope<State::ArrayBuffer>([&]()
+            {
+                set_operation("VertexBuffer::flush",vbo_id);
+                status_cache().bind_buffer(GL_ARRAY_BUFFER,vbo_id);
+                writes.flush([](std::size_t offset,std::span<const float> data)
+                {
+                    glBufferSubData(GL_ARRAY_BUFFER,offset * sizeof(float),data.size_bytes(),data.data());
+                });
+            });
+        }
+
+        /**
+         * @brief Get the dirty ranges waiting for flush()
+         *
+         * @return const DirtyRanges&
+         */
+        const DirtyRanges& get_dirty_ranges() const noexcept
+        {
+            return writes.get_dirty_ranges();
+        }
+
         /**
          * @brief Get the vbo id object
          * 
@@ -110,19 +534,48 @@ namespace graphics
         }
     };
 
-    template <BufferType type,std::size_t len>
+    /**
+     * @brief Vertex Buffer sized at runtime, use it like VertexBuffer<BufferType::Dynamic>
+     *
+     * @tparam type
+     */
+    template <BufferType type>
+    class VertexBuffer<type,std::dynamic_extent> : public GrowableBuffer<float,type>
+    {
+    public:
+        VertexBuffer() noexcept
+            : GrowableBuffer<float,type>("VertexBuffer::update")
+        {
+        }
+
+        explicit VertexBuffer(std::span<const float> data) noexcept
+            : GrowableBuffer<float,type>("VertexBuffer::update",data)
+        {
+        }
+
+        unsigned int get_vbo_id() const noexcept
+        {
+            return this->get_buffer_id();
+        }
+    };
+
+    template <BufferType type,std::size_t len = std::dynamic_extent>
     class ElementBuffer
     {
     private:
         unsigned int ebo_id;
+        GLenum index_type {GL_UNSIGNED_INT};
+        std::optional<unsigned int> restart;
 
     public:
         /**
          * @brief Construct a new Element Buffer object
          * 
          * @param arr 
+         * @param restart   the index that restarts the primitive, draw() enables primitive restart when it is given
          */
-        ElementBuffer(const std::array<unsigned int,len>& arr) noexcept
+        ElementBuffer(const std::array<unsigned int,len>& arr,std::optional<unsigned int> restart = std::nullopt) noexcept
+            : restart(restart)
         {
             glGenBuffers(1,&ebo_id);
             update(arr);
@@ -140,17 +593,17 @@ namespace graphics
          */
         ~ElementBuffer() noexcept
         {
-            glDeleteBuffers(1,&ebo_id);
+            status_cache().delete_buffer(ebo_id);
         }
 
         /**
-         * @brief update Element Buffer in OpenGL
+         * @brief update Element Buffer in OpenGL, the indices are stored in the narrowest type they fit
          * 
          * @param arr 
          */
-        void update(const std::array<unsigned int,len>& arr) const noexcept
+        void update(const std::array<unsigned int,len>& arr) noexcept
         {
-            Scope([&]()
+            RestoreScope<State::VertexArray>([&]()
             {
                 unsigned int buffer_type_enum;
                 if constexpr(type == BufferType::Static)
@@ -160,8 +613,16 @@ namespace graphics
                 else if constexpr(type == BufferType::Stream)
                     buffer_type_enum = GL_STREAM_DRAW;
 
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,ebo_id);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER,sizeof(arr),arr.data(),buffer_type_enum);
+                set_operation("ElementBuffer::update",ebo_id);
+                status_cache().bind_buffer(GL_ELEMENT_ARRAY_BUFFER,ebo_id);
+                index_type = index_type_of(arr,restart);
+                if(index_type == GL_UNSIGNED_INT && restart.value_or(primitive_restart_index) == primitive_restart_index)
+                    glBufferData(GL_ELEMENT_ARRAY_BUFFER,sizeof(arr),arr.data(),buffer_type_enum);
+                else
+                {
+                    const std::vector<std::byte> bytes {narrow_indices(arr,index_type,restart)};
+                    glBufferData(GL_ELEMENT_ARRAY_BUFFER,bytes.size(),bytes.data(),buffer_type_enum);
+                }
             });
         }
 
@@ -175,6 +636,21 @@ namespace graphics
             return ebo_id;
         }
 
+        /**
+         * @brief Get the index type, GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         *
+         * @return GLenum
+         */
+        GLenum get_index_type() const noexcept
+        {
+            return index_type;
+        }
+
+        bool has_primitive_restart() const noexcept
+        {
+            return restart.has_value();
+        }
+
         /**
          * @brief Get the len object
          * 
@@ -186,6 +662,161 @@ namespace graphics
         }
     };
 
+    /**
+     * @brief Element Buffer sized at runtime, use it like ElementBuffer<BufferType::Dynamic>
+     * @note  indices are stored in the narrowest type they fit. when an append() or write() needs a wider type
+     *        the content is read back and widened, which waits for the GPU: give the vertex count up front
+     *        to a buffer that is going to grow
+     *
+     * @tparam type
+     */
+    template <BufferType type>
+    class ElementBuffer<type,std::dynamic_extent> : private GrowableBuffer<std::byte,type>
+    {
+    private:
+        using Storage = GrowableBuffer<std::byte,type>;
+        GLenum index_type;
+        std::optional<unsigned int> restart;
+
+        /**
+         * @brief make sure index_type can hold every index of indices
+         *
+         * @param indices
+         */
+        void fit(std::span<const unsigned int> indices) noexcept(false)
+        {
+            const GLenum needed {index_type_of(indices,restart)};
+            if(index_size(needed) <= index_size(index_type))
+                return;
+
+            Storage::flush();
+            std::vector<std::byte> bytes(Storage::get_len());
+            if(!bytes.empty())
+            {
+                set_operation("ElementBuffer::widen",get_ebo_id());
+                glBindBuffer(GL_COPY_READ_BUFFER,get_ebo_id());
+                glGetBufferSubData(GL_COPY_READ_BUFFER,0,bytes.size(),bytes.data());
+            }
+            const std::vector<unsigned int> old_indices {widen_indices(bytes,index_type,restart)};
+            index_type = needed;
+            Storage::update(narrow_indices(old_indices,index_type,restart));
+        }
+
+    public:
+        /**
+         * @brief Construct a new empty Element Buffer object
+         *
+         * @param vertex_count  the number of vertices the indices will address
+         * @param restart       the index that restarts the primitive, draw() enables primitive restart when it is given
+         */
+        explicit ElementBuffer(std::size_t vertex_count = 0x100,std::optional<unsigned int> restart = std::nullopt) noexcept
+            : Storage("ElementBuffer::update"),index_type(index_type_for(restart ? vertex_count + 1 : vertex_count)),restart(restart)
+        {
+        }
+
+        explicit ElementBuffer(std::span<const unsigned int> data,std::optional<unsigned int> restart = std::nullopt) noexcept(false)
+            : Storage("ElementBuffer::update"),index_type(index_type_of(data,restart)),restart(restart)
+        {
+            Storage::update(narrow_indices(data,index_type,restart));
+        }
+
+        /**
+         * @brief replace the whole content, the index type is chosen again from data
+         *
+         * @param data
+         */
+        void update(std::span<const unsigned int> data) noexcept(false)
+        {
+            index_type = index_type_of(data,restart);
+            Storage::update(narrow_indices(data,index_type,restart));
+        }
+
+        /**
+         * @brief add indices after the current content
+         *
+         * @param data
+         */
+        void append(std::span<const unsigned int> data) noexcept(false)
+        {
+            fit(data);
+            Storage::append(narrow_indices(data,index_type,restart));
+        }
+
+        /**
+         * @brief overwrite some indices, nothing is uploaded until flush()
+         * @warning throw std::out_of_range when data goes past get_len()
+         *
+         * @param offset    by count
+         * @param data
+         */
+        void write(std::size_t offset,std::span<const unsigned int> data) noexcept(false)
+        {
+            fit(data);
+            Storage::write(offset * index_size(index_type),narrow_indices(data,index_type,restart));
+        }
+
+        using Storage::flush;
+        using Storage::clear;
+
+        void reserve(std::size_t new_capacity) noexcept
+        {
+            Storage::reserve(new_capacity * index_size(index_type));
+        }
+
+        std::size_t get_len() const noexcept
+        {
+            return Storage::get_len() / index_size(index_type);
+        }
+
+        std::size_t get_capacity() const noexcept
+        {
+            return Storage::get_capacity() / index_size(index_type);
+        }
+
+        unsigned int get_ebo_id() const noexcept
+        {
+            return this->get_buffer_id();
+        }
+
+        GLenum get_index_type() const noexcept
+        {
+            return index_type;
+        }
+
+        bool has_primitive_restart() const noexcept
+        {
+            return restart.has_value();
+        }
+    };
+
+    /**
+     * @brief Vertex Buffer of a vertex struct, sized at runtime
+     *
+     * @tparam V    the vertex struct, its Layout sets up the vertex array
+     * @tparam type
+     */
+    template <ReflectedVertex V,BufferType type = BufferType::Static>
+    class StructVertexBuffer : public GrowableBuffer<V,type>
+    {
+    public:
+        using Vertex = V;
+
+        StructVertexBuffer() noexcept
+            : GrowableBuffer<V,type>("StructVertexBuffer::update")
+        {
+        }
+
+        explicit StructVertexBuffer(std::span<const V> data) noexcept
+            : GrowableBuffer<V,type>("StructVertexBuffer::update",data)
+        {
+        }
+
+        unsigned int get_vbo_id() const noexcept
+        {
+            return this->get_buffer_id();
+        }
+    };
+
     template <typename T>
     concept VertexBufferService = requires(T t)
     {
@@ -196,6 +827,19 @@ namespace graphics
     concept ElementBufferService = requires(T t)
     {
         {t.get_ebo_id()} -> std::same_as<unsigned int>;
+        {t.get_index_type()} -> std::same_as<GLenum>;
+    };
+
+    /**
+     * @brief one float vertex attribute, the arguments of VertexArray::enable_attrib() without the vertex lenth
+     *
+     */
+    struct VertexAttrib
+    {
+        unsigned int index;         // the index used in GLSL
+        std::size_t len;            // by count
+        std::size_t offset;         // in a single vertex, by count
+        bool normalized {false};
     };
 
     template <VertexBufferService VBO>
@@ -216,7 +860,7 @@ namespace graphics
 
         ~VertexArray() noexcept
         {
-            glDeleteVertexArrays(1,&vao_id);
+            status_cache().delete_vertex_array(vao_id);
         }
 
         unsigned int get_vao_id() const noexcept
@@ -229,6 +873,17 @@ namespace graphics
             return vbo.get_vbo_id();
         }
 
+        /**
+         * @brief bind this vertex array and its vbo, draws of it inside the same Scope then bind nothing
+         * @warning this will change the status of OpenGL
+         *
+         */
+        void bind() const noexcept
+        {
+            status_cache().bind_vertex_array(vao_id);
+            status_cache().bind_buffer(GL_ARRAY_BUFFER,vbo.get_vbo_id());
+        }
+
         /**
          * @brief               bind vertex attrib pointer for OpenGL
          * 
@@ -240,16 +895,87 @@ namespace graphics
          */
         void enable_attrib(unsigned int index,std::size_t len,std::size_t vertex_len,std::size_t offset,bool normalized = false) const noexcept
         {
-            Scope([&]()
+            RestoreScope<State::VertexArray | State::ArrayBuffer>([&]()
             {
-                glBindBuffer(GL_ARRAY_BUFFER,vbo.get_vbo_id());
+                set_operation("VertexArray::enable_attrib",vao_id);
+                status_cache().bind_buffer(GL_ARRAY_BUFFER,vbo.get_vbo_id());
                 //glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,ebo.get_ebo_id());
-                glBindVertexArray(vao_id);
+                status_cache().bind_vertex_array(vao_id);
                 
                 glVertexAttribPointer(index,len,GL_FLOAT,normalized,vertex_len * sizeof(float),(void*)(offset * sizeof(float)));
                 glEnableVertexAttribArray(index);
             });
         }
+
+        /**
+         * @brief bind every vertex attrib pointer of a vertex struct, stride and offsets come from the struct
+         *
+         * @tparam V the vertex struct stored in the vbo
+         */
+        template <ReflectedVertex V>
+        void enable_layout() const noexcept
+        {
+            RestoreScope<State::VertexArray | State::ArrayBuffer>([&]()
+            {
+                set_operation("VertexArray::enable_layout",vao_id);
+                status_cache().bind_buffer(GL_ARRAY_BUFFER,vbo.get_vbo_id());
+                status_cache().bind_vertex_array(vao_id);
+                V::Layout::enable();
+            });
+        }
+
+        /**
+         * @brief bind every vertex attrib pointer of the vertex struct of the vbo
+         *
+         */
+        void enable_layout() const noexcept requires requires {typename VBO::Vertex;}
+        {
+            enable_layout<typename VBO::Vertex>();
+        }
+
+        /**
+         * @brief               bind a per-instance attrib pointer, read from another buffer than the vertices
+         * 
+         * @param instances     the buffer of per-instance data
+         * @param index         the index of the attrib (used in OpenGL GLSL)
+         * @param len           the lenth of this attrib (by count)
+         * @param instance_len  the lenth of the data of a single instance (by count)
+         * @param offset        offset of this attrib in the data of a single instance
+         * @param divisor       the attrib advances once every divisor instances
+         * @param normalized    if need to normalize the data
+         */
+        template <VertexBufferService IBO>
+        void enable_instance_attrib(const IBO& instances,unsigned int index,std::size_t len,std::size_t instance_len,std::size_t offset,unsigned int divisor = 1,bool normalized = false) const noexcept
+        {
+            RestoreScope<State::VertexArray | State::ArrayBuffer>([&]()
+            {
+                set_operation("VertexArray::enable_instance_attrib",vao_id);
+                status_cache().bind_buffer(GL_ARRAY_BUFFER,instances.get_vbo_id());
+                status_cache().bind_vertex_array(vao_id);
+
+                glVertexAttribPointer(index,len,GL_FLOAT,normalized,instance_len * sizeof(float),(void*)(offset * sizeof(float)));
+                glEnableVertexAttribArray(index);
+                glVertexAttribDivisor(index,divisor);
+            });
+        }
+
+        /**
+         * @brief bind every attrib pointer of the struct stored in instances as per-instance data
+         *
+         * @param instances a StructVertexBuffer
+         * @param divisor   the attribs advance once every divisor instances
+         */
+        template <VertexBufferService IBO> requires requires {typename IBO::Vertex;}
+        void enable_instance_layout(const IBO& instances,unsigned int divisor = 1) const noexcept
+        {
+            RestoreScope<State::VertexArray | State::ArrayBuffer>([&]()
+            {
+                set_operation("VertexArray::enable_instance_layout",vao_id);
+                status_cache().bind_buffer(GL_ARRAY_BUFFER,instances.get_vbo_id());
+                status_cache().bind_vertex_array(vao_id);
+                IBO::Vertex::Layout::enable_instanced(divisor);
+            });
+        }
     };
 
     template <VertexBufferService VBO,ElementBufferService EBO>
@@ -280,5 +1006,35 @@ namespace graphics
         {
             return ebo.get_ebo_id();
         }
+
+        /**
+         * @brief bind this vertex array, its vbo and its ebo, and turn primitive restart on when the ebo has a restart index.
+         *        draws of it inside the same Scope then change nothing
+         * @warning this will change the status of OpenGL
+         *
+         */
+        void bind() const noexcept
+        {
+            VertexArray<VBO>::bind();
+            status_cache().bind_buffer(GL_ELEMENT_ARRAY_BUFFER,ebo.get_ebo_id());
+            if constexpr(requires {{ebo.has_primitive_restart()} -> std::same_as<bool>;})
+            {
+                if(ebo.has_primitive_restart())
+                {
+                    status_cache().set_primitive_restart(true);
+                    status_cache().set_primitive_restart_index(restart_index_of(ebo.get_index_type()));
+                }
+            }
+        }
+
+        GLenum get_index_type() const noexcept
+        {
+            return ebo.get_index_type();
+        }
+
+        bool has_primitive_restart() const noexcept
+        {
+            return ebo.has_primitive_restart();
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include <primitive.hpp>
+#include <scope.hpp>
+#include <shader.hpp>
+#include <vertex.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <array>
+#include <cstdlib>
+#include <stdexcept>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+static GLFWwindow* window {nullptr};
+static std::size_t failure_count {0};
+
+void initialize_window() noexcept
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+
+    glfwSetErrorCallback([](int error,const char* description){
+        std::cerr << "GLFW error {}: " << description << std::endl;
+        std::terminate();
+    });
+
+    window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        std::terminate();
+    }
+}
+
+constexpr std::string_view vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPos;\n"
+    "layout (location = 1) in vec3 aColor;\n"
+    "\n"
+    "out vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = vec4(aPos, 0.0, 1.0);\n"
+    "ourColor = aColor;\n"
+    "}\n\0"
+};
+
+constexpr std::string_view fragment_shader_glsl
+{
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "\n"
+    "in vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    FragColor = vec4(ourColor, 1.0);\n"
+    "}\n\0"
+};
+
+constexpr std::size_t vertex_len {5};
+constexpr std::size_t quad_count {8};
+
+void expect(bool condition,std::string_view what) noexcept
+{
+    if(!condition)
+    {
+        std::cerr << what << std::endl;
+        ++failure_count;
+    }
+}
+
+// a row of quads, 4 vertices each
+std::array<float,quad_count * 4 * vertex_len> build_quads() noexcept
+{
+    std::array<float,quad_count * 4 * vertex_len> vertices {};
+    constexpr std::array<std::array<float,2>,4> corners {{{0.0f,0.0f},{1.0f,0.0f},{1.0f,1.0f},{0.0f,1.0f}}};
+    for(std::size_t q = 0;q < quad_count;q++)
+    {
+        const float shade {static_cast<float>(q) / quad_count};
+        for(std::size_t c = 0;c < 4;c++)
+        {
+            float* vertex {vertices.data() + (q * 4 + c) * vertex_len};
+            vertex[0] = -0.9f + 0.225f * (q + corners[c][0] * 0.9f);
+            vertex[1] = -0.2f + 0.4f * corners[c][1];
+            vertex[2] = shade;
+            vertex[3] = 0.5f;
+            vertex[4] = 1.0f - shade;
+        }
+    }
+    return vertices;
+}
+
+// the same quad for every draw, the base vertex of the draw picks which one
+static constexpr std::array<unsigned int,6> quad_indices
+{
+    0,1,2,
+    0,2,3
+};
+
+// every quad as two triangles of one index list
+static constexpr std::array<unsigned int,quad_count * 6> list_indices {[]()
+{
+    std::array<unsigned int,quad_count * 6> indices {};
+    for(unsigned int q = 0;q < quad_count;q++)
+    {
+        for(unsigned int i = 0;i < 6;i++)
+            indices[q * 6 + i] = q * 4 + quad_indices[i];
+    }
+    return indices;
+}()};
+
+int main() noexcept
+{
+    initialize_window();
+
+    try
+    {
+        graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
+        graphics::VertexBuffer<graphics::BufferType::Static,quad_count * 4 * vertex_len> vbo(build_quads());
+        graphics::ElementBuffer<graphics::BufferType::Static,6> quad_ebo(quad_indices);
+        graphics::ElementBuffer<graphics::BufferType::Static,quad_count * 6> list_ebo(list_indices);
+        graphics::VertexArray vao(vbo);
+        graphics::VertexArrayWithEBO quad_vao(vbo,quad_ebo);
+        graphics::VertexArrayWithEBO list_vao(vbo,list_ebo);
+        // position attrib
+        vao.enable_attrib(0,2,vertex_len,0,false);
+        quad_vao.enable_attrib(0,2,vertex_len,0,false);
+        list_vao.enable_attrib(0,2,vertex_len,0,false);
+        // color attrib
+        vao.enable_attrib(1,3,vertex_len,2,false);
+        quad_vao.enable_attrib(1,3,vertex_len,2,false);
+        list_vao.enable_attrib(1,3,vertex_len,2,false);
+
+        // the even quads as vertex ranges
+        graphics::DrawBatch array_batch;
+        for(std::size_t q = 0;q < quad_count;q += 2)
+            array_batch.add(q * 4,4);
+
+        // the odd quads through one quad of indices moved by their base vertex
+        graphics::DrawBatch quad_batch(quad_ebo.get_index_type());
+        for(std::size_t q = 1;q < quad_count;q += 2)
+            quad_batch.add(0,quad_indices.size(),static_cast<int>(q * 4));
+
+        // every other quad of the index list, the offsets follow the index type of the ebo
+        graphics::DrawBatch list_batch(list_ebo.get_index_type());
+        for(std::size_t q = 0;q < quad_count;q += 2)
+            list_batch.add(q * 6,6);
+        for(std::size_t i = 0;i < list_batch.size();i++)
+        {
+            expect(list_batch.get_offsets()[i] == reinterpret_cast<const void*>(i * 2 * 6 * graphics::index_size(list_ebo.get_index_type())),
+                "DrawBatch offset not in bytes of the index type");
+        }
+
+        // a batch built for another index type must not reach glMultiDrawElements
+        graphics::DrawBatch wrong_batch(list_ebo.get_index_type() == GL_UNSIGNED_INT ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT);
+        wrong_batch.add(0,6);
+        bool thrown {false};
+        try
+        {
+            graphics::multi_draw<graphics::Primitives::Triangles>(list_vao,wrong_batch);
+        }
+        catch(const std::invalid_argument&)
+        {
+            thrown = true;
+        }
+        expect(thrown,"multi_draw took a DrawBatch of another index type");
+        wrong_batch.set_index_type(list_ebo.get_index_type());
+        expect(wrong_batch.get_offsets()[0] == nullptr,"DrawBatch::set_index_type broke the offsets");
+        wrong_batch.clear();
+        expect(wrong_batch.size() == 0 && wrong_batch.get_offsets().empty(),"DrawBatch::clear kept offsets");
+
+        program.use();
+        for(std::size_t frame = 0;frame < 4;frame++)
+        {
+            graphics::Scope([&]()
+            {
+                glClearColor(0.1f,0.1f,0.1f,1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+
+                // the even quads from the vertex ranges or from the index list, the odd ones by base vertex
+                if(frame % 2 == 0)
+                    graphics::multi_draw<graphics::Primitives::TriangleFan>(vao,array_batch);
+                else
+                    graphics::multi_draw<graphics::Primitives::Triangles>(list_vao,list_batch);
+                if(frame < 2)
+                    graphics::multi_draw<graphics::Primitives::Triangles>(quad_vao,quad_batch);
+                else
+                    graphics::multi_draw<graphics::Primitives::Triangles>(quad_vao,quad_batch.get_counts(),quad_batch.get_offsets(),quad_batch.get_base_vertices());
+                graphics::multi_draw<graphics::Primitives::TriangleFan>(vao,array_batch.get_firsts(),array_batch.get_counts());
+
+                glfwPollEvents();
+                glfwSwapBuffers(window);
+            });
+        }
+
+        if(failure_count != 0)
+        {
+            std::cerr << failure_count << " failures" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "batches: " << array_batch.size() << " + " << quad_batch.size() << " + " << list_batch.size() << " draws" << std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        std::terminate();
+    }
+    catch(...)
+    {
+        std::cerr << "unknow exception catched" << std::endl;
+        std::terminate();
+    }
+}
\ No newline at end of file
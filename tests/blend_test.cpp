@@ -2,6 +2,7 @@
 #include <image.hpp>
 #include <camera.hpp>
 #include <frame.hpp>
+#include <instance.hpp>
 #include <primitive.hpp>
 #include <scope.hpp>
 #include <shader.hpp>
@@ -14,6 +15,7 @@
 #include <string_view>
 #include <iostream>
 #include <memory>
+#include <vector>
 #include <chrono>
 
 static GLFWwindow* window {nullptr};
@@ -32,7 +34,7 @@ void initialize_window() noexcept
 
     window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
     glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){glViewport(0,0,width,height);});
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
 
     if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -62,6 +64,27 @@ constexpr std::string_view vertex_shader_glsl
     "}\n\0"
 };
 
+constexpr std::string_view instanced_vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "layout (location = 1) in vec4 aColor;\n"
+    "layout (location = 2) in vec2 aTexCoord;\n"
+    "layout (location = 3) in mat4 aTransform;\n"
+    "\n"
+    "uniform mat4 cameraTrans;\n"
+    "\n"
+    "out vec4 ourColor;\n"
+    "out vec2 TexCoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = cameraTrans * aTransform * vec4(aPos, 1.0);\n"
+    "ourColor = aColor;\n"
+    "TexCoord = vec2(aTexCoord.x, 1.0 - aTexCoord.y);\n"
+    "}\n\0"
+};
+
 constexpr std::string_view fragment_shader_glsl
 {
     "#version 330 core\n"
@@ -204,6 +227,7 @@ int main() noexcept
         graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
         graphics::Program only_red_program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(only_red_fragment_shader_glsl)));
         graphics::Program post_kernel_program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(kenel_post_effect_fragment_shader)));
+        graphics::Program grass_program((graphics::VShader(instanced_vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
 
         graphics::VertexBuffer<graphics::BufferType::Static,36> vbo(rect_vertices);
         graphics::ElementBuffer<graphics::BufferType::Static,6> ebo(rect_indices);
@@ -215,6 +239,17 @@ int main() noexcept
         // texture coord attrib
         vao.enable_attrib(2,2,9,7,false);
 
+        // one transform per grass quad, all of them drawn in one call
+        std::vector<graphics::InstanceTransform<3>> grass_transforms;
+        for(std::size_t i = 0;i < 100;i++)
+            grass_transforms.emplace_back(glm::translate(glm::mat4(1.0f),glm::vec3((i % 10) * 0.2f - 1.0f,(i / 10) * 0.2f - 1.0f,1.0f)) * glm::scale(glm::mat4(1.0f),glm::vec3(0.1f,0.1f,1.0f)));
+        graphics::TransformBuffer<3> grass_instances(grass_transforms);
+        graphics::VertexArrayWithEBO grass_vao(vbo,ebo);
+        grass_vao.enable_attrib(0,3,9,0,false);
+        grass_vao.enable_attrib(1,4,9,3,false);
+        grass_vao.enable_attrib(2,2,9,7,false);
+        grass_vao.enable_instance_layout(grass_instances);
+
         graphics::VertexBuffer<graphics::BufferType::Static,72> cube_vbo(cube_vertices);
         graphics::ElementBuffer<graphics::BufferType::Static,36> cube_ebo(cube_indices);
         graphics::VertexArrayWithEBO cube_vao(cube_vbo,cube_ebo);
@@ -323,15 +358,10 @@ int main() noexcept
                     // draw grass
                     graphics::Scope([&]()
                     {
-                        program.use();
-                        program.set_uniform("cameraTrans",cam2.get_matrix());
+                        grass_program.use();
+                        grass_program.set_uniform("cameraTrans",cam2.get_matrix());
                         grass_texture.bind();
-                
-                        for(std::size_t i = 0;i < 100;i++)
-                        {
-                            program.set_uniform("transform",glm::translate(glm::mat4(1.0f),glm::vec3((i % 10) * 0.2f - 1.0f,(i / 10) * 0.2f - 1.0f,1.0f)) * glm::scale(glm::mat4(1.0f),glm::vec3(0.1f,0.1f,1.0f)));
-                            graphics::draw<graphics::Primitives::Triangles>(vao,6);
-                        }
+                        graphics::draw_instanced<graphics::Primitives::Triangles>(grass_vao,6,grass_instances.get_len());
                     });
                 });
 
@@ -2,6 +2,7 @@
 #include <image.hpp>
 #include <camera.hpp>
 #include <frame.hpp>
+#include <mesh_builder.hpp>
 #include <primitive.hpp>
 #include <scope.hpp>
 #include <shader.hpp>
@@ -33,7 +34,7 @@ void initialize_window() noexcept
 
     window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
     glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){glViewport(0,0,width,height);});
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
 
     if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -239,8 +240,13 @@ int main() noexcept
         // texture coord attrib
         vao.enable_attrib(2,2,9,7,false);
 
-        graphics::VertexBuffer<graphics::BufferType::Static,324> cube_vbo(cube_vertices);
-        graphics::VertexArray cube_vao(cube_vbo);
+        // the cube is 36 vertices with every corner repeated, index it
+        graphics::MeshBuilder cube_builder(9);
+        cube_builder.add_vertices(cube_vertices);
+        std::cout << "cube vertices: " << cube_builder.get_source_vertex_count() << " -> " << cube_builder.get_vertex_count() << std::endl;
+        graphics::VertexBuffer<graphics::BufferType::Static> cube_vbo(cube_builder.get_vertices());
+        graphics::ElementBuffer<graphics::BufferType::Static> cube_ebo(cube_builder.get_indices());
+        graphics::VertexArrayWithEBO cube_vao(cube_vbo,cube_ebo);
         // position attrib
         cube_vao.enable_attrib(0,3,9,0,false);
         // color attrib
@@ -326,7 +332,7 @@ int main() noexcept
                     frame1.clear_depth_buffer();
                     //frame1.clear_stencil_buffer();
                     textures[tex_index]->bind();
-                    graphics::draw<graphics::Primitives::Triangles>(cube_vao,0,324);
+                    graphics::draw<graphics::Primitives::Triangles>(cube_vao,cube_builder.get_indices().size());
                 });
 
                 // apply effect & draw to screen
@@ -338,7 +344,7 @@ int main() noexcept
                         post_kernel_program.set_uniform("transform",glm::scale(glm::mat4(1.0f),glm::vec3(2.0f,2.0f,2.0f)) * glm::rotate(glm::mat4(1.0f),static_cast<float>(cos(glfwGetTime()) * 2),glm::vec3(1.0f,1.0f,0.0f)));
                         post_kernel_program.set_uniform("cameraTrans",cam2.get_matrix());
                         frame_tex1.bind();
-                        graphics::draw<graphics::Primitives::Triangles>(cube_vao,0,324);
+                        graphics::draw<graphics::Primitives::Triangles>(cube_vao,cube_builder.get_indices().size());
                     });
 
                     // draw grass
@@ -28,7 +28,7 @@ void initialize_window() noexcept
 
     window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
     glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){glViewport(0,0,width,height);});
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
 
     if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
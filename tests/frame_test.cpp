@@ -30,7 +30,7 @@ void initialize_window() noexcept
 
     window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
     glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){glViewport(0,0,width,height);});
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
 
     if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -144,7 +144,7 @@ int main() noexcept
                     graphics::draw<graphics::Primitives::Triangles>(vao,6);
                 });
 
-                glViewport(0,0,800,600);
+                graphics::set_viewport(0,0,800,600);
                 glClearColor(1.0f, 1.0f, 1.0f, 1.0f); 
                 glClear(GL_COLOR_BUFFER_BIT);
                 frame_tex.bind();
@@ -0,0 +1,222 @@
+#include <geometry_heap.hpp>
+#include <primitive.hpp>
+#include <range_allocator.hpp>
+#include <scope.hpp>
+#include <shader.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <array>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+static GLFWwindow* window {nullptr};
+static std::size_t failure_count {0};
+
+void initialize_window() noexcept
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+
+    glfwSetErrorCallback([](int error,const char* description){
+        std::cerr << "GLFW error {}: " << description << std::endl;
+        std::terminate();
+    });
+
+    window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        std::terminate();
+    }
+}
+
+constexpr std::string_view vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPos;\n"
+    "layout (location = 1) in vec3 aColor;\n"
+    "\n"
+    "out vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = vec4(aPos, 0.0, 1.0);\n"
+    "ourColor = aColor;\n"
+    "}\n\0"
+};
+
+constexpr std::string_view fragment_shader_glsl
+{
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "\n"
+    "in vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    FragColor = vec4(ourColor, 1.0);\n"
+    "}\n\0"
+};
+
+constexpr std::size_t vertex_len {5};
+
+void expect(bool condition,std::string_view what) noexcept
+{
+    if(!condition)
+    {
+        std::cerr << what << std::endl;
+        ++failure_count;
+    }
+}
+
+bool overlap(const graphics::RangeAllocator::Allocation& a,const graphics::RangeAllocator::Allocation& b) noexcept
+{
+    return a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+}
+
+// fill a RangeAllocator with uneven ranges, give them back out of order, it must merge back into one range
+void test_range_allocator() noexcept(false)
+{
+    graphics::RangeAllocator allocator(1000);
+    std::vector<graphics::RangeAllocator::Allocation> allocations;
+    for(std::size_t size = 1;;size = size % 40 + 1)
+    {
+        const graphics::RangeAllocator::Allocation allocation {allocator.allocate(size)};
+        if(!allocation.is_valid())
+            break;
+        expect(allocation.offset + allocation.size <= allocator.get_capacity(),"RangeAllocator range out of capacity");
+        for(const auto& other : allocations)
+            expect(!overlap(allocation,other),"RangeAllocator ranges overlap");
+        allocations.push_back(allocation);
+    }
+    expect(allocations.size() > 1,"RangeAllocator handed out nothing");
+
+    for(std::size_t i = 0;i < allocations.size();i += 2)
+        allocator.free(allocations[i]);
+    // the holes are reused before the allocator gives up
+    const graphics::RangeAllocator::Allocation hole {allocator.allocate(1)};
+    expect(hole.is_valid(),"RangeAllocator did not reuse a freed range");
+    allocator.free(hole);
+    for(std::size_t i = allocations.size();i-- > 0;)
+    {
+        if(i % 2 == 1)
+            allocator.free(allocations[i]);
+    }
+
+    expect(allocator.get_free_size() == allocator.get_capacity(),"RangeAllocator lost free space");
+    const graphics::RangeAllocator::Allocation whole {allocator.allocate(allocator.get_capacity())};
+    expect(whole.is_valid(),"RangeAllocator did not merge its free ranges");
+}
+
+// one quad of the grid, 4 vertices and 6 indices relative to them
+void build_quad(std::vector<float>& vertices,std::size_t cell,std::size_t columns) noexcept(false)
+{
+    const float size {2.0f / columns};
+    const float x {-1.0f + size * (cell % columns)};
+    const float y {-1.0f + size * (cell / columns)};
+    const float shade {static_cast<float>(cell % 5) / 4.0f};
+    vertices = {
+        x + size * 0.9f,y + size * 0.9f,shade,0.5f,1.0f - shade,
+        x + size * 0.9f,y,shade,0.5f,1.0f - shade,
+        x,y,shade,0.5f,1.0f - shade,
+        x,y + size * 0.9f,shade,0.5f,1.0f - shade
+    };
+}
+
+static constexpr std::array<unsigned int,6> quad_indices
+{
+    0,1,3,
+    1,2,3
+};
+
+int main() noexcept
+{
+    initialize_window();
+
+    try
+    {
+        test_range_allocator();
+
+        constexpr std::size_t columns {8};
+        constexpr std::size_t quad_count {40};
+        // 16 quads in a page, so the meshes spread over 3 pages
+        graphics::GeometryHeap heap(vertex_len,{{0,2,0,false},{1,3,2,false}},64,128);
+        graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
+
+        std::vector<graphics::GeometryHandle> handles(quad_count);
+        std::vector<float> vertices;
+        for(std::size_t i = 0;i < quad_count;i++)
+        {
+            build_quad(vertices,i,columns);
+            handles[i] = heap.add(vertices,quad_indices);
+        }
+        expect(heap.get_page_count() == 3,"GeometryHeap did not fill its pages");
+        for(std::size_t i = 0;i < quad_count;i++)
+        {
+            for(std::size_t j = 0;j < i;j++)
+            {
+                if(handles[i].page == handles[j].page)
+                    expect(!overlap(handles[i].vertices,handles[j].vertices) && !overlap(handles[i].indices,handles[j].indices),"GeometryHeap meshes overlap");
+            }
+        }
+
+        program.use();
+        for(std::size_t frame = 0;frame < 6;frame++)
+        {
+            graphics::Scope([&]()
+            {
+                glClearColor(0.1f,0.1f,0.1f,1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+
+                if(frame % 2 == 0)
+                {
+                    for(const auto& handle : handles)
+                        graphics::draw<graphics::Primitives::Triangles>(heap,handle);
+                }
+                else
+                    graphics::multi_draw<graphics::Primitives::Triangles>(heap,handles);
+
+                glfwPollEvents();
+                glfwSwapBuffers(window);
+            });
+
+            // swap half of the meshes every frame, the freed ranges are reused without a new page
+            for(std::size_t i = frame % 2;i < quad_count;i += 2)
+            {
+                heap.remove(handles[i]);
+                expect(!handles[i].is_valid(),"GeometryHeap::remove kept the handle");
+            }
+            for(std::size_t i = frame % 2;i < quad_count;i += 2)
+            {
+                build_quad(vertices,i,columns);
+                handles[i] = heap.add(vertices,quad_indices);
+            }
+            expect(heap.get_page_count() == 3,"GeometryHeap grew while meshes were replaced");
+        }
+
+        if(failure_count != 0)
+        {
+            std::cerr << failure_count << " failures" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "pages: " << heap.get_page_count() << std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        std::terminate();
+    }
+    catch(...)
+    {
+        std::cerr << "unknow exception catched" << std::endl;
+        std::terminate();
+    }
+}
\ No newline at end of file
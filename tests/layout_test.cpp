@@ -0,0 +1,176 @@
+#include <frame.hpp>
+#include <primitive.hpp>
+#include <scope.hpp>
+#include <shader.hpp>
+#include <texture.hpp>
+#include <vertex.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <string_view>
+#include <thread>
+
+static GLFWwindow* window {nullptr};
+
+void initialize_window() noexcept
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+
+    glfwSetErrorCallback([](int error,const char* description){
+        std::cerr << "GLFW error {}: " << description << std::endl;
+        std::terminate();
+    });
+
+    window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        std::terminate();
+    }
+}
+
+constexpr std::string_view vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "layout (location = 1) in vec4 aColor;\n"
+    "layout (location = 2) in vec2 aTexCoord;\n"
+    "layout (location = 3) in uint aCorner;\n"
+    "\n"
+    "uniform mat4 transform;\n"
+    "\n"
+    "out vec4 ourColor;\n"
+    "out vec2 TexCoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = transform * vec4(aPos, 1.0);\n"
+    "ourColor = aCorner == 0u ? vec4(1.0) : aColor;\n"
+    "TexCoord = aTexCoord;\n"
+    "}\n\0"
+};
+
+constexpr std::string_view fragment_shader_glsl
+{
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "\n"
+    "in vec4 ourColor;\n"
+    "in vec2 TexCoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    FragColor = ourColor * vec4(TexCoord, 1.0, 1.0);\n"
+    "}\n\0"
+};
+
+// 24 bytes per vertex, the same rect in vertex_test takes 36
+struct Vertex
+{
+    float position[3];
+    std::uint8_t color[4];
+    graphics::Half uv[2];
+    std::uint32_t corner;
+
+    using Layout = graphics::VertexLayout<
+        graphics::Attrib<0,&Vertex::position>,
+        graphics::Attrib<1,&Vertex::color,graphics::AttribMode::Normalized>,
+        graphics::Attrib<2,&Vertex::uv>,
+        graphics::Attrib<3,&Vertex::corner,graphics::AttribMode::Integer>>;
+};
+
+// what the Layout reflects from Vertex, rather than numbers computed by hand
+static_assert(Vertex::Layout::stride == sizeof(Vertex) && Vertex::Layout::stride == 24);
+static_assert(Vertex::Layout::attrib_count == 4);
+static_assert(Vertex::Layout::attrib<0>::location == 0 && Vertex::Layout::attrib<0>::type == GL_FLOAT && Vertex::Layout::attrib<0>::count == 3);
+static_assert(Vertex::Layout::attrib<1>::location == 1 && Vertex::Layout::attrib<1>::type == GL_UNSIGNED_BYTE && Vertex::Layout::attrib<1>::count == 4);
+static_assert(Vertex::Layout::attrib<2>::location == 2 && Vertex::Layout::attrib<2>::type == GL_HALF_FLOAT && Vertex::Layout::attrib<2>::count == 2);
+static_assert(Vertex::Layout::attrib<3>::location == 3 && Vertex::Layout::attrib<3>::type == GL_UNSIGNED_INT && Vertex::Layout::attrib<3>::count == 1);
+
+/**
+ * @brief the offsets the Layout reflects must be the ones of the members
+ * @note  reflected through a pointer to member, they are only known at run time
+ *
+ * @return bool
+ */
+bool check_offsets() noexcept
+{
+    return Vertex::Layout::attrib<0>::get_offset() == offsetof(Vertex,position)
+        && Vertex::Layout::attrib<1>::get_offset() == offsetof(Vertex,color) && Vertex::Layout::attrib<1>::get_offset() == 12
+        && Vertex::Layout::attrib<2>::get_offset() == offsetof(Vertex,uv) && Vertex::Layout::attrib<2>::get_offset() == 16
+        && Vertex::Layout::attrib<3>::get_offset() == offsetof(Vertex,corner) && Vertex::Layout::attrib<3>::get_offset() == 20;
+}
+
+static const std::array<Vertex,4> rect_vertices
+{{
+    {{1.0f,  1.0f,  0.3f},{255,255,178,255},{1.0f,1.0f},0},    // top right
+    {{1.0f,  -1.0f, 0.0f},{153,76,255,255}, {1.0f,0.0f},1},    // bottom right
+    {{-1.0f, -1.0f, 0.0f},{178,76,25,255},  {0.0f,0.0f},2},    // bottom left
+    {{-1.0f, 1.0f,  0.0f},{255,255,127,0},  {0.0f,1.0f},3}     // top left
+}};
+
+static constexpr std::array<unsigned int,6> rect_indices
+{
+    0,1,3,
+    1,2,3
+};
+
+int main() noexcept
+{
+    initialize_window();
+
+    try
+    {
+        if(!check_offsets())
+        {
+            std::cerr << "Vertex::Layout reflected the wrong offsets" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
+        graphics::StructVertexBuffer<Vertex> vbo(rect_vertices);
+        graphics::ElementBuffer<graphics::BufferType::Static,6> ebo(rect_indices);
+        graphics::VertexArrayWithEBO vao(vbo,ebo);
+        // stride, offsets and types all come from Vertex::Layout
+        vao.enable_layout();
+
+        program.use();
+        program.set_uniform("transform",glm::scale(glm::mat4(1.0f),glm::vec3(0.5f,0.5f,0.5f)));
+
+        for(int i = 0;i < 2;i++)
+        {
+            graphics::Scope([&]()
+            {
+                graphics::draw<graphics::Primitives::Triangles>(vao,6);
+
+                glfwPollEvents();
+                glfwSwapBuffers(window);
+                glClearColor(0.2f,0.3f,0.3f,1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        std::terminate();
+    }
+    catch(...)
+    {
+        std::cerr << "unknow exception catched" << std::endl;
+        std::terminate();
+    }
+}
\ No newline at end of file
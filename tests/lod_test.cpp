@@ -0,0 +1,287 @@
+#include <mesh_builder.hpp>
+#include <mesh_optimizer.hpp>
+#include <primitive.hpp>
+#include <scope.hpp>
+#include <shader.hpp>
+#include <simplify.hpp>
+#include <upload.hpp>
+#include <vertex.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <glad/glad.h>
+#include <glm/ext/matrix_transform.hpp>
+#include <GLFW/glfw3.h>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+static GLFWwindow* window {nullptr};
+
+void initialize_window() noexcept
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+
+    glfwSetErrorCallback([](int error,const char* description){
+        std::cerr << "GLFW error {}: " << description << std::endl;
+        std::terminate();
+    });
+
+    window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        std::terminate();
+    }
+}
+
+constexpr std::string_view vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "layout (location = 1) in vec2 aTexCoord;\n"
+    "\n"
+    "uniform mat4 transform;\n"
+    "\n"
+    "out vec2 TexCoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = transform * vec4(aPos, 1.0);\n"
+    "TexCoord = aTexCoord;\n"
+    "}\n\0"
+};
+
+constexpr std::string_view fragment_shader_glsl
+{
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "\n"
+    "in vec2 TexCoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    FragColor = vec4(TexCoord, 1.0, 1.0);\n"
+    "}\n\0"
+};
+
+// a wavy terrain as unindexed triangles, position and uv
+std::vector<float> terrain_soup(std::size_t size) noexcept(false)
+{
+    std::vector<float> soup;
+    const auto corner {[&](std::size_t x,std::size_t y)
+    {
+        const float u {static_cast<float>(x) / size};
+        const float v {static_cast<float>(y) / size};
+        soup.insert(soup.end(),{u * 2.0f - 1.0f,0.1f * std::sin(u * 12.0f) * std::cos(v * 9.0f),v * 2.0f - 1.0f,u,v});
+    }};
+    for(std::size_t y = 0;y < size;y++)
+    {
+        for(std::size_t x = 0;x < size;x++)
+        {
+            corner(x,y);
+            corner(x + 1,y + 1);
+            corner(x + 1,y);
+            corner(x,y);
+            corner(x,y + 1);
+            corner(x + 1,y + 1);
+        }
+    }
+    return soup;
+}
+
+/**
+ * @brief both meshes draw the same triangles with the same winding, whatever the order of the triangles and vertices
+ *
+ * @param vertices_a
+ * @param indices_a
+ * @param vertices_b
+ * @param indices_b
+ * @param vertex_len
+ * @return bool
+ */
+bool same_triangles(std::span<const float> vertices_a,std::span<const unsigned int> indices_a,
+    std::span<const float> vertices_b,std::span<const unsigned int> indices_b,std::size_t vertex_len) noexcept(false)
+{
+    const auto triangles {[&](std::span<const float> vertices,std::span<const unsigned int> indices)
+    {
+        std::vector<std::vector<float>> result;
+        for(std::size_t t = 0;t + 2 < indices.size();t += 3)
+        {
+            // start from the smallest corner, rotating keeps the winding
+            std::size_t first {0};
+            for(std::size_t i = 1;i < 3;i++)
+            {
+                if(std::lexicographical_compare(vertices.begin() + indices[t + i] * vertex_len,vertices.begin() + (indices[t + i] + 1) * vertex_len,
+                    vertices.begin() + indices[t + first] * vertex_len,vertices.begin() + (indices[t + first] + 1) * vertex_len))
+                    first = i;
+            }
+            std::vector<float>& triangle {result.emplace_back()};
+            for(std::size_t i = 0;i < 3;i++)
+            {
+                const auto vertex {vertices.subspan(indices[t + (first + i) % 3] * vertex_len,vertex_len)};
+                triangle.insert(triangle.end(),vertex.begin(),vertex.end());
+            }
+        }
+        std::sort(result.begin(),result.end());
+        return result;
+    }};
+    return triangles(vertices_a,indices_a) == triangles(vertices_b,indices_b);
+}
+
+/**
+ * @brief positions within the weld epsilon weld to the first vertex even across a cell border,
+ *        vertices whose other attributes differ never weld
+ *
+ * @return bool
+ */
+bool check_welding() noexcept(false)
+{
+    graphics::MeshBuilder builder(5,0.01f);
+    const bool indices_valid {
+        builder.add_vertex(std::array<float,5> {0.0999f,0.0f,0.0f,0.0f,0.0f}) == 0 &&
+        // cell 10 against cell 9 of the first vertex
+        builder.add_vertex(std::array<float,5> {0.1005f,0.0f,0.0f,0.0f,0.0f}) == 0 &&
+        builder.add_vertex(std::array<float,5> {0.1005f,0.0f,0.0f,0.5f,0.0f}) == 1 &&
+        builder.add_vertex(std::array<float,5> {0.2f,0.0f,0.0f,0.0f,0.0f}) == 2 &&
+        // cells -1 and 0 on every axis
+        builder.add_vertex(std::array<float,5> {-0.0004f,-0.0004f,-0.0004f,1.0f,1.0f}) == 3 &&
+        builder.add_vertex(std::array<float,5> {0.0003f,0.0003f,0.0003f,1.0f,1.0f}) == 3};
+    return indices_valid && builder.get_vertex_count() == 4 && builder.get_source_vertex_count() == 6
+        && builder.get_vertices()[0] == 0.0999f && builder.get_vertices()[3 * 5] == -0.0004f;
+}
+
+int main() noexcept
+{
+    initialize_window();
+
+    try
+    {
+        graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
+
+        // soup -> indexed mesh -> cache friendly order -> levels of detail over the same vertices
+        const std::vector<float> soup {terrain_soup(128)};
+        if(!check_welding())
+        {
+            std::cerr << "MeshBuilder welded the wrong vertices" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        graphics::MeshBuilder builder(5);
+        builder.add_vertices(soup);
+        std::cout << "vertices: " << builder.get_source_vertex_count() << " -> " << builder.get_vertex_count() << std::endl;
+
+        std::vector<float> vertices(builder.get_vertices().begin(),builder.get_vertices().end());
+        std::vector<unsigned int> indices(builder.get_indices().begin(),builder.get_indices().end());
+        const std::vector<float> source_vertices {vertices};
+        const std::vector<unsigned int> source_indices {indices};
+        const graphics::MeshOptimizeReport report {graphics::optimize_mesh(vertices,5,indices)};
+        std::cout << "acmr: " << report.before.acmr << " -> " << report.after.acmr
+                  << ", atvr: " << report.before.atvr << " -> " << report.after.atvr << std::endl;
+
+        // the same mesh again, ordered by chunks on the pool
+        std::vector<float> pooled_vertices {source_vertices};
+        std::vector<unsigned int> pooled_indices {source_indices};
+        const graphics::MeshOptimizeReport pooled_report {graphics::optimize_mesh(pooled_vertices,5,pooled_indices,
+            graphics::MeshOptimizeOptions {.chunk_triangles = 4096},&graphics::default_thread_pool())};
+        std::cout << "pooled acmr: " << pooled_report.before.acmr << " -> " << pooled_report.after.acmr << std::endl;
+
+        if(!same_triangles(source_vertices,source_indices,vertices,indices,5) || !same_triangles(source_vertices,source_indices,pooled_vertices,pooled_indices,5))
+        {
+            std::cerr << "optimize_mesh changed the triangles" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if(report.after.acmr > report.before.acmr || pooled_report.after.acmr > pooled_report.before.acmr)
+        {
+            std::cerr << "optimize_mesh made the vertex cache worse" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const std::vector<graphics::LodLevel> chain {graphics::build_lod_chain(indices,vertices,5,5,0.5f,{},&graphics::default_thread_pool())};
+        for(std::size_t i = 0;i < chain.size();i++)
+            std::cout << "level " << i << ": " << chain[i].indices.size() / 3 << " triangles, error " << chain[i].error << std::endl;
+
+        // every level is coarser than the one before, within the same vertices
+        bool chain_valid {chain.size() > 1};
+        for(std::size_t i = 0;i < chain.size();i++)
+        {
+            if(i > 0 && (chain[i].indices.size() >= chain[i - 1].indices.size() || chain[i].error < chain[i - 1].error))
+                chain_valid = false;
+            if(std::any_of(chain[i].indices.begin(),chain[i].indices.end(),[&](unsigned int index){return index >= vertices.size() / 5;}))
+                chain_valid = false;
+        }
+        if(!chain_valid || graphics::select_lod(chain,0.0f) != 0 || graphics::select_lod(chain,1e6f) != chain.size() - 1)
+        {
+            std::cerr << "build_lod_chain made a broken chain of levels" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // the vertices are copied into staging memory by a worker thread, drawing waits until they are resident
+        graphics::UploadQueue uploads;
+        graphics::VertexBuffer<graphics::BufferType::Static> vbo;
+        graphics::UploadTicket vertices_upload {uploads.stage(vbo,0,vertices.size())};
+        auto filled {graphics::default_thread_pool().submit([&]()
+        {
+            std::copy(vertices.begin(),vertices.end(),vertices_upload.get_staging_as<float>().begin());
+            vertices_upload.finish();
+        })};
+        std::vector<std::unique_ptr<graphics::ElementBuffer<graphics::BufferType::Static>>> ebos;
+        std::vector<std::unique_ptr<graphics::VertexArrayWithEBO<decltype(vbo),graphics::ElementBuffer<graphics::BufferType::Static>>>> vaos;
+        for(const auto& level : chain)
+        {
+            ebos.push_back(std::make_unique<graphics::ElementBuffer<graphics::BufferType::Static>>(level.indices));
+            vaos.push_back(std::make_unique<graphics::VertexArrayWithEBO<decltype(vbo),graphics::ElementBuffer<graphics::BufferType::Static>>>(vbo,*ebos.back()));
+            // position attrib
+            vaos.back()->enable_attrib(0,3,5,0,false);
+            // texture coord attrib
+            vaos.back()->enable_attrib(1,2,5,3,false);
+        }
+
+        program.use();
+        program.set_uniform("transform",glm::rotate(glm::mat4(1.0f),0.6f,glm::vec3(1.0f,0.0f,0.0f)));
+
+        for(std::size_t i = 0;i < chain.size() * 2;i++)
+        {
+            uploads.update();
+            graphics::Scope([&]()
+            {
+                graphics::set_polygon_model(graphics::PolygonModes::Line);
+                if(vertices_upload.is_resident())
+                    graphics::draw<graphics::Primitives::Triangles>(*vaos[i / 2],chain[i / 2].indices.size());
+
+                glfwPollEvents();
+                glfwSwapBuffers(window);
+                glClearColor(0.2f,0.3f,0.3f,1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+            });
+        }
+
+        filled.get();
+        uploads.flush();
+        std::cout << "vertices resident: " << vertices_upload.is_resident() << std::endl;
+
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        std::terminate();
+    }
+    catch(...)
+    {
+        std::cerr << "unknow exception catched" << std::endl;
+        std::terminate();
+    }
+}
\ No newline at end of file
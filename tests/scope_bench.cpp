@@ -0,0 +1,176 @@
+#include "timer.hpp"
+#include <primitive.hpp>
+#include <scope.hpp>
+#include <shader.hpp>
+#include <vertex.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+#include <iostream>
+
+static GLFWwindow* window {nullptr};
+
+// count every heap allocation made while measuring
+static bool counting {false};
+static std::size_t allocation_count {0};
+
+void* operator new(std::size_t size)
+{
+    if(counting)
+        ++allocation_count;
+    if(void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr,std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void initialize_window() noexcept
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+
+    glfwSetErrorCallback([](int error,const char* description){
+        std::cerr << "GLFW error {}: " << description << std::endl;
+        std::terminate();
+    });
+
+    window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        std::terminate();
+    }
+}
+
+constexpr std::string_view vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = vec4(aPos, 1.0);\n"
+    "}\n\0"
+};
+
+constexpr std::string_view fragment_shader_glsl
+{
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    FragColor = vec4(1.0,1.0,1.0,1.0);\n"
+    "}\n\0"
+};
+
+static constexpr std::array<float,12> rect_vertices
+{
+    0.1f,  0.1f,  0.0f,
+    0.1f,  -0.1f, 0.0f,
+    -0.1f, -0.1f, 0.0f,
+    -0.1f, 0.1f,  0.0f
+};
+
+static constexpr std::array<unsigned int,6> rect_indices
+{
+    0,1,3,
+    1,2,3
+};
+
+int main() noexcept
+{
+    initialize_window();
+
+    try
+    {
+        constexpr std::size_t frame_count {100};
+        constexpr std::size_t draws_per_frame {1000};
+
+        graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
+        graphics::VertexBuffer<graphics::BufferType::Static,12> vbo(rect_vertices);
+        graphics::ElementBuffer<graphics::BufferType::Static,6> ebo(rect_indices);
+        graphics::VertexArrayWithEBO vao(vbo,ebo);
+        vao.enable_attrib(0,3,3,0,false);
+
+        auto render_frame = [&]()
+        {
+            // nested like the blend_test frame loop
+            graphics::Scope([&]()
+            {
+                graphics::Scope([&]()
+                {
+                    graphics::Scope([&]()
+                    {
+                        program.use();
+                        graphics::enable_depth_test<graphics::TestFuncType::Lequal>();
+                        vao.bind();
+                        for(std::size_t i = 0;i < draws_per_frame;i++)
+                        {
+                            // one Scope per draw, like objects drawn with their own status
+                            graphics::Scope([&]()
+                            {
+                                graphics::draw<graphics::Primitives::Triangles>(vao,6);
+                            });
+                        }
+                    });
+                });
+            });
+        };
+
+#ifdef GLAD_INSTRUMENT
+        graphics::enable_call_accounting();
+#endif
+
+        // warm up, the status cache is synced and learns the element buffer of vao here
+        render_frame();
+        glFinish();
+
+        test::TimeRecorder recorder;
+        counting = true;
+        for(std::size_t i = 0;i < frame_count;i++)
+            render_frame();
+        counting = false;
+        glFinish();
+        auto span {recorder.get_time_span_ns()};
+
+        std::cout << "draws: " << frame_count * draws_per_frame << std::endl;
+        std::cout << "ns per draw: " << span.count() / (frame_count * draws_per_frame) << std::endl;
+        std::cout << "heap allocations: " << allocation_count << std::endl;
+#ifdef GLAD_INSTRUMENT
+        std::cout << "gl calls: " << graphics::call_accounting().to_json() << std::endl;
+#endif
+
+        if(allocation_count != 0)
+        {
+            std::cerr << "a Scope or draw() allocated on the heap" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        std::terminate();
+    }
+    catch(...)
+    {
+        std::cerr << "unknow exception catched" << std::endl;
+        std::terminate();
+    }
+}
\ No newline at end of file
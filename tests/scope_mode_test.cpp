@@ -0,0 +1,186 @@
+#include <frame.hpp>
+#include <primitive.hpp>
+#include <scope.hpp>
+#include <shader.hpp>
+#include <texture.hpp>
+#include <vertex.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <array>
+#include <cstdlib>
+#include <string_view>
+#include <iostream>
+
+// built once per Scope mode, see tests/CMakeLists.txt
+#if defined(GLBIND_TRUSTED_SCOPE)
+static constexpr std::string_view scope_mode {"trusted"};
+#elif defined(GLBIND_VALIDATE_SCOPE)
+static constexpr std::string_view scope_mode {"validate"};
+#else
+static constexpr std::string_view scope_mode {"default"};
+#endif
+
+static GLFWwindow* window {nullptr};
+static std::size_t leak_count {0};
+static std::size_t failure_count {0};
+
+void initialize_window() noexcept
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+
+    glfwSetErrorCallback([](int error,const char* description){
+        std::cerr << "GLFW error {}: " << description << std::endl;
+        std::terminate();
+    });
+
+    window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        std::terminate();
+    }
+}
+
+constexpr std::string_view vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec3 aPos;\n"
+    "layout (location = 1) in vec2 aTexCoord;\n"
+    "\n"
+    "out vec2 TexCoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = vec4(aPos, 1.0);\n"
+    "TexCoord = aTexCoord;\n"
+    "}\n\0"
+};
+
+constexpr std::string_view fragment_shader_glsl
+{
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "\n"
+    "in vec2 TexCoord;\n"
+    "\n"
+    "uniform sampler2D ourTexture;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    FragColor = texture(ourTexture, TexCoord);\n"
+    "}\n\0"
+};
+
+static constexpr std::array<float,20> rect_vertices
+{
+    1.0f,  1.0f,  0.0f, 1.0f, 1.0f,  // top right
+    1.0f,  -1.0f, 0.0f, 1.0f, 0.0f,  // bottom right
+    -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,  // bottom left
+    -1.0f, 1.0f,  0.0f, 0.0f, 1.0f   // top left
+};
+
+static constexpr std::array<unsigned int,6> rect_indices
+{
+    0,1,3,
+    1,2,3
+};
+
+/**
+ * @brief the bindings OpenGL holds must be the ones it held before what
+ *
+ * @param clean
+ * @param what
+ */
+void expect_clean(const graphics::StatusRecord& clean,std::string_view what) noexcept
+{
+    graphics::StatusRecord now;
+    graphics::StatusCache::query(now);
+    for(const graphics::Field field : {graphics::Field::VertexArray,graphics::Field::ArrayBuffer,graphics::Field::Texture,
+        graphics::Field::Framebuffer,graphics::Field::Renderbuffer})
+    {
+        if(!graphics::StatusCache::same_field(field,clean,now))
+        {
+            std::cerr << scope_mode << ": " << what << " left " << graphics::field_name(field) << " bound" << std::endl;
+            ++failure_count;
+        }
+    }
+}
+
+int main() noexcept
+{
+    initialize_window();
+
+    try
+    {
+        graphics::set_scope_leak_handler([](const graphics::ScopeLeak& leak)
+        {
+            graphics::print_scope_leak(leak);
+            ++leak_count;
+        });
+
+        graphics::StatusRecord clean;
+        graphics::StatusCache::query(clean);
+
+        graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
+        graphics::VertexBuffer<graphics::BufferType::Dynamic,20> vbo(rect_vertices);
+        graphics::ElementBuffer<graphics::BufferType::Static,6> ebo(rect_indices);
+        graphics::VertexArrayWithEBO vao(vbo,ebo);
+        vao.enable_attrib(0,3,5,0,false);
+        vao.enable_attrib(1,2,5,3,false);
+        expect_clean(clean,"VertexArray::enable_attrib");
+
+        graphics::TextureRGB<graphics::TextureType::Texture2D> frame_tex(nullptr,3,0,0,128,64);
+        expect_clean(clean,"Texture::Texture");
+        graphics::Frame frame(frame_tex);
+        expect_clean(clean,"Frame::Frame");
+        program.use();
+
+        for(int i = 0;i < 2;i++)
+        {
+            // the Scopes of the caller follow the build mode, the binds glbind makes for itself never leak
+            graphics::Scope([&]()
+            {
+                frame.fill_color(0.0f,0.0f,0.0f,1.0f);
+                frame.clear_color_buffer();
+                frame.clear_depth_buffer();
+                expect_clean(clean,"Frame::clear_color_buffer");
+
+                vbo.update(rect_vertices);
+                expect_clean(clean,"VertexBuffer::update");
+
+                graphics::draw<graphics::Primitives::Triangles>(vao,6);
+                graphics::draw<graphics::Primitives::Triangles>(vao,0,4);
+                expect_clean(clean,"draw");
+
+                graphics::ScreenFrame::fill_color(1.0f,1.0f,1.0f,1.0f);
+                graphics::ScreenFrame::clear_color_buffer();
+                expect_clean(clean,"ScreenFrame::clear_color_buffer");
+                glfwPollEvents();
+                glfwSwapBuffers(window);
+            });
+        }
+
+        if(leak_count != 0 || failure_count != 0)
+        {
+            std::cerr << scope_mode << ": " << leak_count << " leaks, " << failure_count << " bindings left behind" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << scope_mode << ": no leak" << std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        std::terminate();
+    }
+    catch(...)
+    {
+        std::cerr << "unknow exception catched" << std::endl;
+        std::terminate();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include <primitive.hpp>
+#include <scope.hpp>
+#include <shader.hpp>
+#include <stream.hpp>
+#include <vertex.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+static GLFWwindow* window {nullptr};
+static std::size_t mismatch_count {0};
+
+void initialize_window() noexcept
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+
+    glfwSetErrorCallback([](int error,const char* description){
+        std::cerr << "GLFW error {}: " << description << std::endl;
+        std::terminate();
+    });
+
+    window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        std::terminate();
+    }
+}
+
+constexpr std::string_view vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPos;\n"
+    "layout (location = 1) in vec3 aColor;\n"
+    "\n"
+    "out vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = vec4(aPos, 0.0, 1.0);\n"
+    "ourColor = aColor;\n"
+    "}\n\0"
+};
+
+constexpr std::string_view fragment_shader_glsl
+{
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "\n"
+    "in vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    FragColor = vec4(ourColor, 1.0);\n"
+    "}\n\0"
+};
+
+constexpr std::size_t vertex_len {5};
+constexpr std::size_t stride {vertex_len * sizeof(float)};
+
+// particles orbiting the center, rebuilt on the CPU every frame as one small triangle each
+void build_particles(std::vector<float>& vertices,std::size_t particle_count,float time) noexcept(false)
+{
+    vertices.clear();
+    for(std::size_t i = 0;i < particle_count;i++)
+    {
+        const float angle {time + 6.2831853f * i / particle_count};
+        const float radius {0.3f + 0.5f * static_cast<float>(i % 7) / 7.0f};
+        const float x {radius * std::cos(angle)};
+        const float y {radius * std::sin(angle)};
+        const float shade {static_cast<float>(i % 3) / 2.0f};
+        vertices.insert(vertices.end(),{x,y + 0.02f,1.0f,shade,0.2f});
+        vertices.insert(vertices.end(),{x - 0.02f,y - 0.02f,1.0f,shade,0.2f});
+        vertices.insert(vertices.end(),{x + 0.02f,y - 0.02f,1.0f,shade,0.2f});
+    }
+}
+
+int main() noexcept
+{
+    initialize_window();
+
+    try
+    {
+        constexpr std::size_t frames_in_flight {3};
+        constexpr std::size_t particle_count {256};
+        constexpr std::size_t frame_count {frames_in_flight * 4 + 1};
+
+        graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
+        // two pushes a frame: the particles, then one more triangle on top
+        graphics::StreamBuffer<frames_in_flight> stream((particle_count + 1) * 3 * stride + stride);
+        graphics::VertexArray vao(stream);
+        // position attrib
+        vao.enable_attrib(0,2,vertex_len,0,false);
+        // color attrib
+        vao.enable_attrib(1,3,vertex_len,2,false);
+
+        program.use();
+        std::vector<float> vertices;
+        for(std::size_t frame = 0;frame < frame_count;frame++)
+        {
+            graphics::Scope([&]()
+            {
+                glClearColor(0.1f,0.1f,0.1f,1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+
+                build_particles(vertices,particle_count,0.1f * frame);
+                const graphics::StreamRegion particles {stream.push<float>(vertices,stride)};
+                graphics::draw<graphics::Primitives::Triangles>(vao,particles.get_first(stride),particle_count * 3);
+
+                // a region written in place, it must be committed before drawing from it
+                graphics::StreamRegion marker {stream.allocate(3 * stride,stride)};
+                const float marker_vertices[3 * vertex_len] {0.0f,0.05f,1.0f,1.0f,1.0f,-0.05f,-0.05f,1.0f,1.0f,1.0f,0.05f,-0.05f,1.0f,1.0f,1.0f};
+                std::memcpy(marker.data,marker_vertices,sizeof(marker_vertices));
+                stream.commit();
+                graphics::draw<graphics::Primitives::Triangles>(vao,marker.get_first(stride),3);
+
+                // every frame of storage is reused in turn once its fence has signaled
+                if(particles.offset / stream.get_frame_size() != frame % frames_in_flight
+                    || marker.offset / stream.get_frame_size() != frame % frames_in_flight)
+                {
+                    std::cerr << "frame " << frame << ": region at " << particles.offset << " outside the frame in use" << std::endl;
+                    ++mismatch_count;
+                }
+
+                stream.end_frame();
+                glfwPollEvents();
+                glfwSwapBuffers(window);
+            });
+        }
+
+        if(mismatch_count != 0)
+            return EXIT_FAILURE;
+        std::cout << "frames: " << frame_count << ", stalls: " << stream.get_stall_count() << std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        std::terminate();
+    }
+    catch(...)
+    {
+        std::cerr << "unknow exception catched" << std::endl;
+        std::terminate();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include <primitive.hpp>
+#include <scope.hpp>
+#include <shader.hpp>
+#include <strip.hpp>
+#include <vertex.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+static GLFWwindow* window {nullptr};
+
+void initialize_window() noexcept
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+
+    glfwSetErrorCallback([](int error,const char* description){
+        std::cerr << "GLFW error {}: " << description << std::endl;
+        std::terminate();
+    });
+
+    window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        std::terminate();
+    }
+}
+
+constexpr std::string_view vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPos;\n"
+    "layout (location = 1) in vec3 aColor;\n"
+    "\n"
+    "out vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = vec4(aPos, 0.0, 1.0);\n"
+    "ourColor = aColor;\n"
+    "}\n\0"
+};
+
+constexpr std::string_view fragment_shader_glsl
+{
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "\n"
+    "in vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    FragColor = vec4(ourColor, 1.0);\n"
+    "}\n\0"
+};
+
+constexpr std::size_t vertex_len {5};
+
+using Triangle = std::array<unsigned int,3>;
+
+// the same triangle with the same winding, whatever corner it starts from
+Triangle canonical(unsigned int a,unsigned int b,unsigned int c) noexcept
+{
+    if(b < a && b < c)
+        return {b,c,a};
+    if(c < a && c < b)
+        return {c,a,b};
+    return {a,b,c};
+}
+
+/**
+ * @brief the triangles a restart strip draws as Primitives::TriangleStrip, degenerate ones dropped
+ *
+ * @param strips
+ * @param restart
+ * @return std::vector<Triangle>
+ */
+std::vector<Triangle> decode_strips(std::span<const unsigned int> strips,unsigned int restart) noexcept(false)
+{
+    std::vector<Triangle> triangles;
+    std::size_t begin {0};
+    while(begin < strips.size())
+    {
+        const std::size_t end {static_cast<std::size_t>(std::find(strips.begin() + begin,strips.end(),restart) - strips.begin())};
+        for(std::size_t k = begin;k + 2 < end;k++)
+        {
+            const unsigned int a {strips[k]},b {strips[k + 1]},c {strips[k + 2]};
+            if(a == b || b == c || c == a)
+                continue;
+            triangles.push_back((k - begin) % 2 == 0 ? canonical(a,b,c) : canonical(b,a,c));
+        }
+        begin = end + 1;
+    }
+    std::sort(triangles.begin(),triangles.end());
+    return triangles;
+}
+
+// a (side + 1) x (side + 1) grid of vertices, two triangles a cell, with one cell left out to break the strips
+void build_grid(std::vector<float>& vertices,std::vector<unsigned int>& indices,std::size_t side) noexcept(false)
+{
+    for(std::size_t y = 0;y <= side;y++)
+    {
+        for(std::size_t x = 0;x <= side;x++)
+        {
+            const float u {static_cast<float>(x) / side},v {static_cast<float>(y) / side};
+            vertices.insert(vertices.end(),{u * 1.8f - 0.9f,v * 1.8f - 0.9f,u,v,1.0f - u});
+        }
+    }
+    for(std::size_t y = 0;y < side;y++)
+    {
+        for(std::size_t x = 0;x < side;x++)
+        {
+            if(x == side / 2 && y == side / 2)
+                continue;
+            const unsigned int i {static_cast<unsigned int>(y * (side + 1) + x)};
+            const unsigned int up {static_cast<unsigned int>(i + side + 1)};
+            indices.insert(indices.end(),{i,i + 1,up,i + 1,up + 1,up});
+        }
+    }
+}
+
+int main() noexcept
+{
+    initialize_window();
+
+    try
+    {
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        // 289 vertices, so the strip is stored as 16 bits indices with 0xFFFF as its restart index
+        build_grid(vertices,indices,16);
+        const std::vector<unsigned int> strips {graphics::stripify(indices,graphics::primitive_restart_index)};
+
+        std::vector<Triangle> expected;
+        for(std::size_t i = 0;i + 2 < indices.size();i += 3)
+            expected.push_back(canonical(indices[i],indices[i + 1],indices[i + 2]));
+        std::sort(expected.begin(),expected.end());
+        if(decode_strips(strips,graphics::primitive_restart_index) != expected)
+        {
+            std::cerr << "stripify changed the triangles or their winding" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if(strips.size() >= indices.size())
+        {
+            std::cerr << "stripify made " << strips.size() << " indices out of " << indices.size() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
+        graphics::VertexBuffer<graphics::BufferType::Static> vbo(vertices);
+        graphics::ElementBuffer<graphics::BufferType::Static> list_ebo(indices);
+        graphics::ElementBuffer<graphics::BufferType::Static> strip_ebo(strips,graphics::primitive_restart_index);
+        graphics::VertexArrayWithEBO list_vao(vbo,list_ebo);
+        graphics::VertexArrayWithEBO strip_vao(vbo,strip_ebo);
+        // position attrib
+        list_vao.enable_attrib(0,2,vertex_len,0,false);
+        strip_vao.enable_attrib(0,2,vertex_len,0,false);
+        // color attrib
+        list_vao.enable_attrib(1,3,vertex_len,2,false);
+        strip_vao.enable_attrib(1,3,vertex_len,2,false);
+
+        program.use();
+        std::size_t failure_count {0};
+        for(std::size_t frame = 0;frame < 4;frame++)
+        {
+            graphics::Scope([&]()
+            {
+                glClearColor(0.1f,0.1f,0.1f,1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+
+                // the list and the strip cover the same pixels, every other frame shows the strip
+                if(frame % 2 == 0)
+                    graphics::draw<graphics::Primitives::Triangles>(list_vao,indices.size());
+                else
+                    graphics::draw<graphics::Primitives::TriangleStrip>(strip_vao,strips.size());
+                // the strip enabled primitive restart only for its own draw
+                if(glIsEnabled(GL_PRIMITIVE_RESTART))
+                {
+                    std::cerr << "frame " << frame << ": primitive restart left enabled" << std::endl;
+                    ++failure_count;
+                }
+
+                glfwPollEvents();
+                glfwSwapBuffers(window);
+            });
+        }
+
+        if(failure_count != 0)
+            return EXIT_FAILURE;
+        std::cout << "list: " << indices.size() << " indices, strips: " << strips.size() << " indices" << std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        std::terminate();
+    }
+    catch(...)
+    {
+        std::cerr << "unknow exception catched" << std::endl;
+        std::terminate();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include <primitive.hpp>
+#include <scope.hpp>
+#include <shader.hpp>
+#include <vertex.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <span>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+static GLFWwindow* window {nullptr};
+static std::size_t failure_count {0};
+
+void initialize_window() noexcept
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR,3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR,3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
+
+    glfwSetErrorCallback([](int error,const char* description){
+        std::cerr << "GLFW error {}: " << description << std::endl;
+        std::terminate();
+    });
+
+    window = glfwCreateWindow(800,600,"test",nullptr,nullptr);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window,[](GLFWwindow* window,int width,int height){graphics::set_viewport(0,0,width,height);});
+
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        std::terminate();
+    }
+}
+
+constexpr std::string_view vertex_shader_glsl
+{
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPos;\n"
+    "layout (location = 1) in vec3 aColor;\n"
+    "\n"
+    "out vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "gl_Position = vec4(aPos, 0.0, 1.0);\n"
+    "ourColor = aColor;\n"
+    "}\n\0"
+};
+
+constexpr std::string_view fragment_shader_glsl
+{
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "\n"
+    "in vec3 ourColor;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "    FragColor = vec4(ourColor, 1.0);\n"
+    "}\n\0"
+};
+
+constexpr std::size_t vertex_len {5};
+constexpr std::size_t quad_count {8};
+
+void expect(bool condition,std::string_view what) noexcept
+{
+    if(!condition)
+    {
+        std::cerr << what << std::endl;
+        ++failure_count;
+    }
+}
+
+/**
+ * @brief read back count elements of T from the start of a buffer
+ *
+ * @tparam T
+ * @param buffer_id
+ * @param count
+ * @return std::vector<T>
+ */
+template <typename T>
+std::vector<T> read_buffer(unsigned int buffer_id,std::size_t count) noexcept(false)
+{
+    std::vector<T> data(count);
+    glBindBuffer(GL_COPY_READ_BUFFER,buffer_id);
+    glGetBufferSubData(GL_COPY_READ_BUFFER,0,count * sizeof(T),data.data());
+    return data;
+}
+
+// a row of quads as two triangles each, every vertex gets the shade of its quad
+std::array<float,quad_count * 6 * vertex_len> build_quads(float shade) noexcept
+{
+    std::array<float,quad_count * 6 * vertex_len> vertices {};
+    constexpr std::array<std::array<float,2>,6> corners {{{0.0f,0.0f},{1.0f,0.0f},{1.0f,1.0f},{0.0f,0.0f},{1.0f,1.0f},{0.0f,1.0f}}};
+    for(std::size_t q = 0;q < quad_count;q++)
+    {
+        for(std::size_t c = 0;c < 6;c++)
+        {
+            float* vertex {vertices.data() + (q * 6 + c) * vertex_len};
+            vertex[0] = -0.9f + 0.225f * (q + corners[c][0] * 0.9f);
+            vertex[1] = -0.2f + 0.4f * corners[c][1];
+            vertex[2] = shade;
+            vertex[3] = shade;
+            vertex[4] = shade;
+        }
+    }
+    return vertices;
+}
+
+/**
+ * @brief write two separate ranges and one touching the first, check they are flushed as written
+ *        and that the elements between the writes keep their content
+ *
+ * @tparam B        a vertex buffer with write(), flush() and get_dirty_ranges()
+ * @param vbo
+ * @param expected  the content of vbo, updated with the writes
+ * @param what
+ */
+template <typename B>
+void test_writes(B& vbo,std::span<float> expected,std::string_view what) noexcept(false)
+{
+    const std::array<float,3> ones {1.0f,1.0f,1.0f};
+    const std::array<float,2> halves {0.5f,0.5f};
+    vbo.write(2,ones);
+    vbo.write(12,ones);
+    expect(vbo.get_dirty_ranges().get_ranges().size() == 2,"separate writes were merged");
+    vbo.write(5,halves);
+    expect(vbo.get_dirty_ranges().get_ranges().size() == 2,"touching writes were not merged");
+    expect(vbo.get_dirty_ranges().get_dirty_len() == 8,"dirty ranges cover elements never written");
+
+    std::copy(ones.begin(),ones.end(),expected.begin() + 2);
+    std::copy(ones.begin(),ones.end(),expected.begin() + 12);
+    std::copy(halves.begin(),halves.end(),expected.begin() + 5);
+    vbo.flush();
+    expect(vbo.get_dirty_ranges().empty(),"flush kept dirty ranges");
+
+    const std::vector<float> content {read_buffer<float>(vbo.get_vbo_id(),expected.size())};
+    if(!std::equal(content.begin(),content.end(),expected.begin()))
+    {
+        std::cerr << what << ": flush changed elements that were not written" << std::endl;
+        ++failure_count;
+    }
+}
+
+int main() noexcept
+{
+    initialize_window();
+
+    try
+    {
+        graphics::Program program((graphics::VShader(vertex_shader_glsl)),(graphics::FShader(fragment_shader_glsl)));
+
+        std::array<float,quad_count * 6 * vertex_len> fixed_expected {build_quads(0.3f)};
+        graphics::VertexBuffer<graphics::BufferType::Dynamic,fixed_expected.size()> fixed_vbo(fixed_expected);
+        test_writes(fixed_vbo,fixed_expected,"VertexBuffer<type,len>");
+
+        std::array<float,quad_count * 6 * vertex_len> growable_expected {build_quads(0.6f)};
+        graphics::VertexBuffer<graphics::BufferType::Dynamic> growable_vbo(growable_expected);
+        test_writes(growable_vbo,growable_expected,"VertexBuffer<type>");
+
+        // indices of the growable buffer, rewired quad by quad
+        std::vector<unsigned int> indices(quad_count * 6);
+        for(std::size_t i = 0;i < indices.size();i++)
+            indices[i] = static_cast<unsigned int>(i);
+        graphics::ElementBuffer<graphics::BufferType::Dynamic> ebo {std::span<const unsigned int>(indices)};
+        const std::array<unsigned int,6> first_quad {0,1,2,3,4,5};
+        ebo.write(12,first_quad);
+        ebo.write(30,first_quad);
+        std::copy(first_quad.begin(),first_quad.end(),indices.begin() + 12);
+        std::copy(first_quad.begin(),first_quad.end(),indices.begin() + 30);
+        ebo.flush();
+        const std::vector<std::byte> bytes {read_buffer<std::byte>(ebo.get_ebo_id(),indices.size() * graphics::index_size(ebo.get_index_type()))};
+        expect(graphics::widen_indices(bytes,ebo.get_index_type()) == indices,"ElementBuffer<type>: flush changed indices that were not written");
+
+        graphics::VertexArray fixed_vao(fixed_vbo);
+        graphics::VertexArrayWithEBO growable_vao(growable_vbo,ebo);
+        // position attrib
+        fixed_vao.enable_attrib(0,2,vertex_len,0,false);
+        growable_vao.enable_attrib(0,2,vertex_len,0,false);
+        // color attrib
+        fixed_vao.enable_attrib(1,3,vertex_len,2,false);
+        growable_vao.enable_attrib(1,3,vertex_len,2,false);
+
+        program.use();
+        for(std::size_t frame = 0;frame < 4;frame++)
+        {
+            graphics::Scope([&]()
+            {
+                glClearColor(0.1f,0.1f,0.1f,1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+
+                // one quad lights up per frame, a single small upload each
+                const std::array<float,3> lit {1.0f,0.8f,0.2f};
+                for(std::size_t c = 0;c < 6;c++)
+                    fixed_vbo.write((frame * 6 + c) * vertex_len + 2,lit);
+                fixed_vbo.flush();
+
+                if(frame % 2 == 0)
+                    graphics::draw<graphics::Primitives::Triangles>(fixed_vao,0,quad_count * 6);
+                else
+                    graphics::draw<graphics::Primitives::Triangles>(growable_vao,ebo.get_len());
+
+                glfwPollEvents();
+                glfwSwapBuffers(window);
+            });
+        }
+
+        if(failure_count != 0)
+        {
+            std::cerr << failure_count << " failures" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "writes flushed as written" << std::endl;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "exception: " << e.what() << std::endl;
+        std::terminate();
+    }
+    catch(...)
+    {
+        std::cerr << "unknow exception catched" << std::endl;
+        std::terminate();
+    }
+}
\ No newline at end of file